@@ -0,0 +1 @@
+../src/abstraction/channel_test.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../src/abstraction/colouring_test.cc
\ No newline at end of file
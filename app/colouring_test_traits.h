@@ -0,0 +1 @@
+../src/abstraction/colouring_test_traits.h
\ No newline at end of file
@@ -0,0 +1 @@
+../src/abstraction/fpu_test.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../src/abstraction/interrupt_thread_test.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../src/abstraction/switch_test.cc
\ No newline at end of file
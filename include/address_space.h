@@ -28,8 +28,18 @@ public:
     Log_Addr attach(const Segment & seg);
     Log_Addr attach(const Segment & seg, Log_Addr addr);
     void detach(const Segment & seg);
+    void detach(const Segment & seg, Log_Addr addr);
 
     Phy_Addr physical(Log_Addr address);
+
+    // Drop translations (all or those for [from, to)) from the TLBs of all CPUs
+    static void flush();
+    static void flush(Log_Addr from, Log_Addr to);
+
+private:
+    void flush(const Segment & seg, Log_Addr addr);
+
+    static void flush(void * range);
 };
 
 __END_SYS
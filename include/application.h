@@ -8,6 +8,8 @@
 extern "C"
 {
     void * malloc(size_t);
+    void * realloc(void *, size_t);
+    void * memalign(size_t, size_t);
     void free(void *);
 }
 
@@ -16,8 +18,12 @@ __BEGIN_SYS
 class Application
 {
     friend class Init_Application;
+    friend class Thread;
     friend void * ::malloc(size_t);
+    friend void * ::memalign(size_t, size_t);
     friend void ::free(void *);
+    friend void * ::operator new(size_t);
+    friend void * ::operator new[](size_t);
 
 private:
     static void init();
@@ -88,7 +88,23 @@ public:
         // Mask to clear flags (by ANDing)
         CR0_CLEAR       = (CR0_PE | CR0_EM | CR0_WP),
         // Mask to set flags (by ORing)
-        CR0_SET         = (CR0_PE | CR0_PG)
+        // (WP makes supervisor writes honor read-only pages, as needed by copy-on-write)
+        CR0_SET         = (CR0_PE | CR0_PG | CR0_WP)
+    };
+
+    // CR4 Flags
+    enum {
+        CR4_VME		= 0x00000001,
+        CR4_PVI		= 0x00000002,
+        CR4_TSD		= 0x00000004,
+        CR4_DE		= 0x00000008,
+        CR4_PSE		= 0x00000010,
+        CR4_PAE		= 0x00000020,
+        CR4_MCE		= 0x00000040,
+        CR4_PGE		= 0x00000080,
+        CR4_PCE		= 0x00000100,
+        CR4_OSFXSR	= 0x00000200,
+        CR4_OSXMMEXCPT	= 0x00000400
     };
 
     // Segment Flags
@@ -102,6 +118,7 @@ public:
         SEG_DPL2	= 0x40,
         SEG_PRE		= 0x80,
         SEG_TSS		= 0x09,
+        SEG_TASK	= 0x05,
         SEG_INT		= 0x0e,
         SEG_TRAP	= 0x0f,
         SEG_32		= 0x40,
@@ -113,7 +130,8 @@ public:
         SEG_APP_CODE    = (SEG_PRE  | SEG_NOSYS | SEG_DPL2 | SEG_DPL1 | SEG_CODE | SEG_RW   | SEG_ACC),   // P, DPL=3, S, C, W, A
         SEG_APP_DATA    = (SEG_PRE  | SEG_NOSYS | SEG_DPL2 | SEG_DPL1 | SEG_RW   | SEG_ACC  ),   // P, DPL=3, S,    W, A
         SEG_IDT_ENTRY   = (SEG_PRE  | SEG_INT   | SEG_DPL2 | SEG_DPL1 ),
-        SEG_TSS0        = (SEG_PRE  | SEG_TSS   | SEG_DPL2 | SEG_DPL1 )
+        SEG_TSS0        = (SEG_PRE  | SEG_TSS   | SEG_DPL2 | SEG_DPL1 ),
+        SEG_TASK_GATE   = (SEG_PRE  | SEG_TASK )
     };
 
     // DPL/RPL for application (user) and system (supervisor) modes 
@@ -132,7 +150,9 @@ public:
         GDT_APP_CODE  = 3,
         GDT_APP_DATA  = 4,
         GDT_TSS0      = 5,
-        GDT_LAST      = GDT_TSS0
+        GDT_TSS_PF    = 6,
+        GDT_TSS1      = 7, // followed by the TSSs of the other non-boot CPUs
+        GDT_LAST      = GDT_TSS1
     };
 
     // GDT Selectors
@@ -143,7 +163,8 @@ public:
         SEL_SYS_DATA  = (GDT_SYS_DATA << 3)  | PL_SYS,
         SEL_APP_CODE  = (GDT_APP_CODE << 3)  | PL_APP,
         SEL_APP_DATA  = (GDT_APP_DATA << 3)  | PL_APP,
-        SEL_TSS0      = (GDT_TSS0     << 3)  | PL_SYS
+        SEL_TSS0      = (GDT_TSS0     << 3)  | PL_SYS,
+        SEL_TSS_PF    = (GDT_TSS_PF   << 3)  | PL_SYS
     };
 
     // GDT Entry
@@ -203,8 +224,8 @@ public:
     };
     static const unsigned int IDT_ENTRIES = 256;
 
-    // TSS no longer used, since software context switch is faster
-    // it's left here for reference
+    // TSS no longer used for context switching, since software context switch is faster
+    // (TSS0 and the page fault task are the only ones)
     struct TSS {
         Reg16 back_link;
         Reg16 zero1;
@@ -247,25 +268,24 @@ public:
     };
 
     // CPU Context
+    // What a thread leaves on top of its stack when it gives up the CPU from C code: the callee-saved
+    // registers and where to return to. Everything else is either clobbered by the call according to
+    // the ABI or saved beforehand in a Full_Context (see switch_context() and init_stack())
     class Context
     {
     public:
-        Context(const Log_Addr & entry): _eflags(FLAG_DEFAULTS), _eip(entry) {}
+        Context(const Log_Addr & entry): _edi(0), _esi(0), _ebx(0), _ebp(0), _eip(entry) {}
 
         void save() volatile;
         void load() const volatile;
 
         friend Debug & operator<<(Debug & db, const Context & c) {
             db << hex
-               << "{eflags=" << c._eflags
-               << ",eax=" << c._eax
-               << ",ebx=" << c._ebx
-               << ",ecx=" << c._ecx
-               << ",edx=" << c._edx
+               << "{ebx=" << c._ebx
                << ",esi=" << c._esi
                << ",edi=" << c._edi
                << ",ebp=" << reinterpret_cast<void *>(c._ebp)
-               << ",esp=" << reinterpret_cast<void *>(c._esp)
+               << ",esp=" << &c
                << ",eip=" << reinterpret_cast<void *>(c._eip)
                << ",cs="  << cs()
                << ",ds="  << ds()
@@ -278,6 +298,23 @@ public:
             return db;
         }
 
+    private:
+        Reg32 _edi;
+        Reg32 _esi;
+        Reg32 _ebx;
+        Reg32 _ebp;
+        Reg32 _eip;
+    };
+
+    // The whole register set, as pushed by switch_context() (PUSHF + PUSHA) under a Context
+    class Full_Context
+    {
+    public:
+        Full_Context(const Log_Addr & entry): _eflags(FLAG_DEFAULTS), _eip(entry) {}
+
+        // Pops a Full_Context and returns to its _eip (a new thread's first Context returns here)
+        static void load();
+
     private:
         Reg32 _edi;
         Reg32 _esi;
@@ -291,6 +328,19 @@ public:
         Reg32 _eip;
     };
 
+    // FPU/MMX/SSE Context, as stored by FXSAVE (which requires 16-byte alignment)
+    class FPU_Context
+    {
+    public:
+        FPU_Context() {}
+
+        void save() { ASM("fxsave %0" : "=m"(_area)); }
+        void load() const { ASM("fxrstor %0" : : "m"(_area)); }
+
+    private:
+        Reg8 _area[512];
+    } __attribute__((aligned(16)));
+
     // I/O ports
     typedef Reg16 IO_Port;
     typedef Reg16 IO_Irq;
@@ -314,7 +364,9 @@ public:
 
     static void halt() { ASM("hlt"); }
 
+    // Cooperative switches from C code only save a Context, preemptive ones save every register
     static void switch_context(Context * volatile * o, Context * volatile n);
+    static void switch_context_lean(Context * volatile * o, Context * volatile n);
 
     static Flags flags() { return eflags(); }
     static void flags(const Flags flags) { eflags(flags); }
@@ -362,16 +414,42 @@ public:
     static Reg32 ntohl(Reg32 v)	{ return htonl(v); }
     static Reg16 ntohs(Reg16 v)	{ return htons(v); }
 
+    // Stack painting (see Traits<IA32>::paint_stacks)
+    static const bool paint_stacks = Traits<IA32>::paint_stacks;
+    static const Reg32 STACK_PAINT = 0xdeadbeef;
+
+    // Lazy FPU/SSE context switching (see Traits<IA32>::fpu)
+    // With CR0.TS set, the first FPU/SSE instruction raises EXC_NODEV, whose handler then swaps FPU_Contexts
+    // CR0.TS and the FPU registers belong to each CPU, but the scheduler tracks a single owner, thus single-core only
+    static const bool fpu = Traits<IA32>::fpu && !Traits<System>::multicore;
+
+    // Whether the CPU has FXSAVE/FXRSTOR and SSE (CPUID.01H:EDX.FXSR and EDX.SSE), without which fpu has no effect
+    static bool fpu_supported() {
+        Reg32 a = 1, b, c, d;
+        ASM("cpuid" : "+a"(a), "=b"(b), "=c"(c), "=d"(d));
+        return (d & (1 << 24)) && (d & (1 << 25));
+    }
+
+    static void fpu_init() { Reg32 mxcsr = 0x1f80; ASM("fninit; ldmxcsr %0" : : "m"(mxcsr)); }
+    static void fpu_enable() { ASM("clts"); }
+    static void fpu_disable() { cr0(cr0() | CR0_TS); }
+    static bool fpu_enabled() { return !(cr0() & CR0_TS); }
+
     // IA32 first decrements the stack pointer and then writes into the stack, that's why we decrement it by an int
     template<typename ... Tn>
     static Context * init_stack(const Log_Addr & stack, unsigned int size, void (* exit)(), int (* entry)(Tn ...), Tn ... an) {
+        if(paint_stacks)
+            for(Reg32 * w = stack; w < static_cast<Reg32 *>(stack + size); w++)
+                *w = STACK_PAINT;
         Log_Addr sp = stack + size - sizeof(int);
         sp -= SIZEOF<Tn ... >::Result;
         init_stack_helper(sp, an ...);
         sp -= sizeof(int *);
         *static_cast<int *>(sp) = Log_Addr(exit);
+        sp -= sizeof(Full_Context);
+        new (sp) Full_Context(entry);
         sp -= sizeof(Context);
-        return new (sp) Context(entry);
+        return new (sp) Context(&Full_Context::load);
     }
 
 public:
@@ -6,6 +6,7 @@
 #include <system/memory_map.h>
 #include <utility/string.h>
 #include <utility/list.h>
+#include <utility/bitmap.h>
 #include <utility/debug.h>
 #include <cpu.h>
 #include <mmu.h>
@@ -18,10 +19,21 @@ class IA32_MMU: public MMU_Common<10, 10, 12>
 
 private:
     typedef Grouping_List<Frame> List;
+    typedef Simple_List<Frame> Zeroed_List;
 
     static const unsigned int PHY_MEM = Memory_Map<Machine>::PHY_MEM;
 
+    // Above this, reloading CR3 is cheaper than invalidating page by page
+    static const unsigned int FLUSH_PAGES = 32;
+
 public:
+    static const bool large_pages = Traits<IA32_MMU>::large_pages;
+    static const unsigned int LARGE_PAGE_SIZE = sizeof(Page) * PT_ENTRIES;
+
+    static const bool colouring = Traits<IA32_MMU>::colouring;
+    static const unsigned int COLOURS = Traits<IA32_MMU>::colours;
+    static const unsigned int ALL_COLOURS = (COLOURS < 32) ? (1U << COLOURS) - 1 : ~0U;
+
     // Page Flags
     class IA32_Flags
     {
@@ -36,7 +48,7 @@ public:
             DRT  = 0x040, // Dirty (only for PTEs, 0=clean, 1=dirty)
             PS   = 0x080, // Page Size (for PDEs, 0=4KBytes, 1=4MBytes)
             GLB  = 0X100, // Global Page (0=local, 1=global)
-            EX   = 0x200, // User Def. (0=non-executable, 1=executable)
+            COW  = 0x200, // User Def. (0=private, 1=copy-on-write)
             CT   = 0x400, // User Def. (0=non-contiguous, 1=contiguous)
             IO   = 0x800, // User Def. (0=memory, 1=I/O)
             APP  = (PRE | RW  | ACC | USR),
@@ -57,7 +69,8 @@ public:
         			     ((f & Flags::CWT) ? PWT : 0) |
         			     ((f & Flags::CD)  ? PCD : 0) |
         			     ((f & Flags::CT)  ? CT  : 0) |
-        			     ((f & Flags::IO)  ? PCI : 0) ) {}
+        			     ((f & Flags::IO)  ? PCI : 0) |
+        			     ((f & Flags::LARGE) ? (PS | CT) : 0) ) {}
 
         operator unsigned int() const { return _flags; }
 
@@ -76,6 +89,17 @@ public:
         PT_Entry & operator[](unsigned int i) { return _entry[i]; }
         
         void map(int from, int to, IA32_Flags flags) {
+            if(colouring) {
+        	for( ; from < to; from++) {
+        	    Phy_Addr frame = alloc_coloured(budget_colour(from));
+        	    if(!frame) { // the rest stays unmapped, so touching it faults for good
+        		db<IA32_MMU>(WRN) << "IA32_MMU::Page_Table::map(): out of memory!" << endl;
+        		return;
+        	    }
+        	    _entry[from] = frame | flags;
+        	}
+        	return;
+            }
             Phy_Addr * addr = alloc(to - from);
             if(addr)
         	remap(addr, from, to, flags);
@@ -88,6 +112,12 @@ public:
             remap(alloc(to - from), from, to, flags);
         }
 
+        // Reserved pages are kept not-present (but non-null) until touched, see IA32_MMU::fault()
+        void reserve(int from, int to, IA32_Flags flags) {
+            for( ; from < to; from++)
+        	_entry[from] = flags & ~IA32_Flags::PRE;
+        }
+
         void remap(Phy_Addr addr, int from, int to, IA32_Flags flags) {
             addr = align_page(addr);
             for( ; from < to; from++) {
@@ -98,7 +128,7 @@ public:
 
         void unmap(int from, int to) {
             for( ; from < to; from++) {
-        	free(_entry[from]);
+        	release(_entry[from]);
         	_entry[from] = 0;
             }
         }
@@ -126,25 +156,127 @@ public:
     public:
         Chunk() {}
 
-        Chunk(unsigned int bytes, Flags flags): _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(IA32_Flags(flags)), _pt(calloc(_pts)) {
-            if(flags & IA32_Flags::CT)
+        Chunk(unsigned int bytes, Flags flags): _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(IA32_Flags(flags)), _lazy(flags & Flags::LAZY), _attached_pd(0) {
+            if(large(bytes, _flags)) { // 4 MB aligned frames mapped directly by PDEs
+                _to = _pts * PT_ENTRIES;
+                _pt = alloc(_to, PT_ENTRIES);
+                if(_pt)
+                    return;
+                db<IA32_MMU>(WRN) << "IA32_MMU::Chunk(bytes=" << bytes << "): no large page available, using small pages!" << endl;
+                _to = pages(bytes);
+            }
+            _flags = _flags & ~IA32_Flags::PS;
+            _pt = calloc(_pts);
+            if(_flags & IA32_Flags::CT)
         	_pt->map_contiguous(_from, _to, _flags);
+            else if(_lazy)
+        	_pt->reserve(_from, _to, _flags);
             else 
         	_pt->map(_from, _to, _flags);
         }
 
-        Chunk(Phy_Addr phy_addr, unsigned int bytes, Flags flags): _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(IA32_Flags(flags)), _pt(calloc(_pts)) {
-            _pt->remap(phy_addr, _from, _to, flags);
+        // Clone: with "cow", both chunks share the frames read-only and a page is only copied on the first write to it
+        // (a clone that fails, for lack of memory or because the chunk maps device memory, is left empty, see pt())
+        Chunk(const Chunk & chunk, bool cow): _from(chunk._from), _to(chunk._to), _pts(chunk._pts), _flags(chunk._flags), _pt(0), _lazy(chunk._lazy), _attached_pd(0) {
+            if(_flags & IA32_Flags::IO) { // device frames belong to no one, so they are neither shared nor copied
+                db<IA32_MMU>(WRN) << "IA32_MMU::Chunk(chunk=" << &chunk << "): device memory can't be cloned!" << endl;
+                _from = _to = _pts = 0;
+                return;
+            }
+
+            if(_flags & IA32_Flags::PS) {
+                _pt = alloc(_to, PT_ENTRIES);
+                if(!_pt) {
+                    _from = _to = _pts = 0;
+                    return;
+                }
+                memcpy(phy2log(_pt), phy2log(chunk._pt), size());
+                return;
+            }
+
+            _pt = calloc(_pts);
+            if(!_pt) {
+                _from = _to = _pts = 0;
+                return;
+            }
+
+            if(_flags & IA32_Flags::CT) { // copying is the only way to keep it contiguous
+                Phy_Addr addr = alloc(_to - _from);
+                if(!addr) {
+                    free(_pt, _pts);
+                    _pt = 0;
+                    _from = _to = _pts = 0;
+                    return;
+                }
+                _pt->remap(addr, _from, _to, _flags);
+                memcpy(phy2log(phy_address()), phy2log(chunk.phy_address()), size());
+                return;
+            }
+
+            unsigned int i;
+            for(i = _from; i < _to; i++) {
+                unsigned int entry = (*chunk._pt)[i];
+                if(!(entry & IA32_Flags::PRE)) // reserved pages stay independent
+                    (*_pt)[i] = entry;
+                else if(cow && share(entry)) {
+                    if(entry & IA32_Flags::RW)
+                        entry = (entry & ~IA32_Flags::RW) | IA32_Flags::COW;
+                    (*chunk._pt)[i] = entry;
+                    (*_pt)[i] = entry;
+                } else {
+                    Phy_Addr frame = alloc();
+                    if(!frame)
+                        break;
+                    memcpy(phy2log(frame), phy2log(indexes(entry)), sizeof(Page));
+                    (*_pt)[i] = frame | (entry & (sizeof(Page) - 1));
+                }
+            }
+
+            if(i < _to) { // out of memory: give shares and copies back (the original keeps its pages copy-on-write)
+                db<IA32_MMU>(WRN) << "IA32_MMU::Chunk(chunk=" << &chunk << "): out of memory!" << endl;
+                for(unsigned int j = _from; j < i; j++)
+                    if((*_pt)[j] & IA32_Flags::PRE)
+                        release((*_pt)[j]);
+                free(_pt, _pts);
+                _pt = 0;
+                _from = _to = _pts = 0;
+            }
+
+            // The original chunk might be attached to the current address space
+            flush_tlb();
+        }
+
+        Chunk(Phy_Addr phy_addr, unsigned int bytes, Flags flags): _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(IA32_Flags(flags)), _lazy(false), _attached_pd(0) {
+            if(large(bytes, _flags) && !(phy_addr & (LARGE_PAGE_SIZE - 1))) {
+                _to = _pts * PT_ENTRIES;
+                _pt = phy_addr;
+                return;
+            }
+            _flags = _flags & ~IA32_Flags::PS;
+            _pt = calloc(_pts);
+            _pt->remap(phy_addr, _from, _to, _flags);
         }
 
         ~Chunk() {
+            if(!_pt) // a failed clone
+                return;
+
+            if(_flags & IA32_Flags::PS) {
+                if(!(_flags & IA32_Flags::IO))
+                    free(_pt, _to - _from);
+                return;
+            }
+
             if(!(_flags & IA32_Flags::IO)) {
         	if(_flags & IA32_Flags::CT)
         	    free((*_pt)[_from], _to - _from);
         	else
                     for( ; _from < _to; _from++)
-                        free((*_pt)[_from]);
-            }
+                        release((*_pt)[_from]);
+            } else
+                for( ; _from < _to; _from++) // give up shares, but never the memory
+                    if((*_pt)[_from] & IA32_Flags::PRE)
+                        unshare((*_pt)[_from]);
             free(_pt, _pts);
         }
 
@@ -153,12 +285,53 @@ public:
         Page_Table * pt() const { return _pt; }
         unsigned int size() const { return (_to - _from) * sizeof(Page); }
 
+        // Unmaps the page at "offset" (the first one by default), so that running over it from above faults for good
+        void guard(unsigned int offset = 0) {
+            unsigned int pg = _from + offset / sizeof(Page);
+            _pt->unmap(pg, pg + 1);
+        }
+
+        // Gives the frames behind [offset, offset + bytes) of a lazy chunk back, leaving the pages reserved again
+        void discard(unsigned int offset, unsigned int bytes) {
+            if(!_lazy)
+                return;
+            unsigned int from = _from + offset / sizeof(Page);
+            unsigned int to = from + pages(bytes);
+            for(unsigned int i = from; i < to; i++)
+                if((*_pt)[i] & IA32_Flags::PRE)
+                    release((*_pt)[i]);
+            _pt->reserve(from, to, _flags);
+        }
+
+        // Bytes actually backed by frames (smaller than size() for lazy chunks)
+        unsigned int resident() const { return resident(0, size()); }
+        unsigned int resident(unsigned int offset, unsigned int bytes) const {
+            if(!_lazy)
+                return bytes;
+            unsigned int from = _from + offset / sizeof(Page);
+            unsigned int to = from + pages(bytes);
+            unsigned int pgs = 0;
+            for(unsigned int i = from; i < to; i++)
+                if((*_pt)[i] & IA32_Flags::PRE)
+                    pgs++;
+            return pgs * sizeof(Page);
+        }
+
+        // Last attachment of this chunk (used by Directory::detach() to avoid searching)
+        void attached(Page_Table * pd, unsigned int from) const { _attached_pd = pd; _attached_from = from; }
+        bool attached(Page_Table * pd, unsigned int * from) const {
+            *from = _attached_from;
+            return _attached_pd == pd;
+        }
+
         Phy_Addr phy_address() const {
+            if(_flags & IA32_Flags::PS)
+                return Phy_Addr(_pt);
             return (_flags & IA32_Flags::CT) ? Phy_Addr(indexes((*_pt)[_from])) : Phy_Addr(false);
         }
 
         int resize(unsigned int amount) {
-            if(_flags & IA32_Flags::CT)
+            if(_flags & (IA32_Flags::CT | IA32_Flags::PS))
         	return 0;
 
             unsigned int pgs = pages(amount);
@@ -168,23 +341,38 @@ public:
                 unsigned int pts = _pts + page_tables(pgs - free_pgs);
                 Page_Table * pt = calloc(pts);
                 memcpy(pt, _pt, _pts * sizeof(Page));
+                if(_attached_pd) // the last attachment follows the copy (the extra page tables are only mapped by new attachments)
+                    for(unsigned int i = 0; i < _pts; i++)
+                        (*_attached_pd)[_attached_from + i] = (Phy_Addr(pt) + i * sizeof(Page_Table)) | _flags;
                 free(_pt, _pts);
                 _pt = pt;
                 _pts = pts;
             }
 
-            _pt->map(_to, _to + pgs, _flags);
+            if(_lazy)
+        	_pt->reserve(_to, _to + pgs, _flags);
+            else
+        	_pt->map(_to, _to + pgs, _flags);
             _to += pgs;
 
             return pgs * sizeof(Page);
         }
 
+    private:
+        // Large pages are used when explicitly requested (Flags::LARGE) or for contiguous chunks spanning whole 4 MB pages
+        static bool large(unsigned int bytes, IA32_Flags flags) {
+            return large_pages && ((flags & IA32_Flags::PS) || ((flags & IA32_Flags::CT) && !(flags & IA32_Flags::IO) && !(bytes & (LARGE_PAGE_SIZE - 1))));
+        }
+
     private:
         unsigned int _from;
         unsigned int _to;
         unsigned int _pts;
         IA32_Flags _flags;
         Page_Table * _pt;
+        bool _lazy;
+        mutable Page_Table * _attached_pd;
+        mutable unsigned int _attached_from;
     };
 
     // Page Directory
@@ -194,23 +382,41 @@ public:
     class Directory 
     {
     public:
-        Directory() : _pd(calloc(1)), _free(true) {
-            for(unsigned int i = directory(PHY_MEM); i < PD_ENTRIES; i++)
-        	(*_pd)[i] = (*_master)[i];
+        // Page directories are allocated along with a frame for the bitmap of their used entries, which is
+        // thus shared by all Directory objects for the same page directory (see used())
+        // The system half is copied from the master, which might have changed since INIT (e.g. the heap and the I/O APIC),
+        // with a block copy, the rest is cleared
+        Directory() : _pd(alloc(2)), _free(true), _used(used(_pd)) {
+            unsigned int sys = directory(PHY_MEM);
+            unsigned int * pd = reinterpret_cast<unsigned int *>((void *)phy2log(_pd));
+            memset(pd, 0, sys * sizeof(unsigned int));
+            memcpy(&pd[sys], reinterpret_cast<unsigned int *>((void *)phy2log(_master)) + sys, (PD_ENTRIES - sys) * sizeof(unsigned int));
+            *_used = Bitmap<PD_ENTRIES>();
+            for(unsigned int i = _master_used.first_set(sys); i < PD_ENTRIES; i = _master_used.first_set(i + 1))
+                _used->set(i);
         }
 
-        Directory(Page_Directory * pd) : _pd(pd), _free(false) {}
+        Directory(Page_Directory * pd) : _pd(pd), _free(false), _used(used(pd)) {}
 
-        ~Directory() { if(_free) free(_pd); }
+        ~Directory() { if(_free) free(_pd, 2); }
         
         Phy_Addr pd() const { return _pd; }
 
-        void activate() const { IA32::pdp(reinterpret_cast<IA32::Reg32>(_pd)); }
+        void activate() const {
+            // Reloading CR3 flushes the TLB (but global entries), so avoid it if nothing changes
+            if(IA32::pdp() != reinterpret_cast<IA32::Reg32>(_pd)) {
+                IA32::pdp(reinterpret_cast<IA32::Reg32>(_pd));
+                // CR3 isn't saved on task switches, so TSS0 must know it for the page fault task
+                reinterpret_cast<IA32::TSS *>(Memory_Map<Machine>::TSS0)->pdbr = reinterpret_cast<IA32::Reg32>(_pd);
+            }
+        }
 
         Log_Addr attach(const Chunk & chunk) {
-            for(unsigned int i = 0; i < PD_ENTRIES; i++)
-        	if(attach(i, chunk.pt(), chunk.pts(), chunk.flags()))
+            for(unsigned int i = search(chunk.pts()); i < PD_ENTRIES; i = search(chunk.pts(), i))
+        	if(attach(i, chunk.pt(), chunk.pts(), chunk.flags())) {
+        	    chunk.attached(_pd, i);
         	    return i << DIRECTORY_SHIFT;
+        	}
             return false;
         }
 
@@ -219,54 +425,98 @@ public:
             if(!attach(from, chunk.pt(), chunk.pts(), chunk.flags()))
         	return Log_Addr(false);
 
+            chunk.attached(_pd, from);
             return from << DIRECTORY_SHIFT;
         }
 
- 	void detach(const Chunk & chunk) {
- 	    for(unsigned int i = 0; i < PD_ENTRIES; i++)
+ 	// Both return where the chunk was mapped, so callers can flush stale translations
+ 	Log_Addr detach(const Chunk & chunk) {
+            unsigned int from;
+            if(chunk.attached(_pd, &from) && (indexes((*_pd)[from]) == indexes(chunk.pt()))) {
+        	detach(from, chunk.pt(), chunk.pts());
+        	return from << DIRECTORY_SHIFT;
+            }
+ 	    for(unsigned int i = _used->first_set(); i < PD_ENTRIES; i = _used->first_set(i + 1))
         	if(indexes((*_pd)[i]) == indexes(chunk.pt())) {
         	    detach(i, chunk.pt(), chunk.pts());
-        	    return;
+        	    return i << DIRECTORY_SHIFT;
         	}
             db<IA32_MMU>(WRN) << "IA32_MMU::Directory::detach(pt=" 
         		      << chunk.pt() << ") failed!" << endl;
+            return false;
  	}
 
- 	void detach(const Chunk & chunk, Log_Addr addr) {
+ 	Log_Addr detach(const Chunk & chunk, Log_Addr addr) {
             unsigned int from = directory(addr);
             if(indexes((*_pd)[from]) != indexes(chunk.pt())) {
         	db<IA32_MMU>(WRN) << "IA32_MMU::Directory::detach(pt=" 
         		 	  << chunk.pt() << ",addr="
         			  << addr << ") failed!" << endl;
-        	return;
+        	return Log_Addr(false);
             }
             detach(from, chunk.pt(), chunk.pts());
+            return from << DIRECTORY_SHIFT;
  	}
 
         Phy_Addr physical(Log_Addr addr) {
-            Page_Table * pt = (Page_Table *)(void *)(*_pd)[directory(addr)];
+            PD_Entry pde = (*_pd)[directory(addr)];
+            if(pde & IA32_Flags::PS)
+                return (pde & ~(LARGE_PAGE_SIZE - 1)) | (addr & (LARGE_PAGE_SIZE - 1));
+            Page_Table * pt = (Page_Table *)(void *)pde;
             return (*pt)[page(addr)] | offset(addr);
         }
 
     private:
+        static Bitmap<PD_ENTRIES> * used(Page_Directory * pd) {
+            if(pd == _master)
+                return &_master_used;
+            return reinterpret_cast<Bitmap<PD_ENTRIES> *>((void *)phy2log(Phy_Addr(pd) + sizeof(Page)));
+        }
+
+        // First run of "n" free entries at or after "from" (PD_ENTRIES if there is none)
+        unsigned int search(unsigned int n, unsigned int from = 0) const {
+            for(unsigned int i = _used->first_reset(from); i + n <= PD_ENTRIES; i = _used->first_reset(i)) {
+                unsigned int j = _used->first_set(i);
+                if(j - i >= n)
+                    return i;
+                i = j;
+            }
+            return PD_ENTRIES;
+        }
+
         bool attach(unsigned int from, const Page_Table * pt,
         	    unsigned int n, IA32_Flags flags) {
+            if(from + n > PD_ENTRIES)
+        	return false;
+            bool free = true;
             for(unsigned int i = from; i < from + n; i++)
-        	if((*_pd)[i])
-        	    return false;
-            for(unsigned int i = from; i < from + n; i++, pt++)
-        	(*_pd)[i] = Phy_Addr(pt) | flags;
+        	if((*_pd)[i]) { // entries might have been set without a Directory (e.g. by SETUP)
+        	    _used->set(i);
+        	    free = false;
+        	}
+            if(!free)
+        	return false;
+            // Large chunks carry the base of their frames instead of page tables
+            unsigned int step = (flags & IA32_Flags::PS) ? LARGE_PAGE_SIZE : sizeof(Page_Table);
+            Phy_Addr addr = pt;
+            for(unsigned int i = from; i < from + n; i++, addr += step) {
+        	(*_pd)[i] = addr | flags;
+        	_used->set(i);
+            }
             return true;
         }
 
         void detach(unsigned int from, const Page_Table * pt, unsigned int n) {
-            for(unsigned int i = from; i < from + n; i++)
+            for(unsigned int i = from; i < from + n; i++) {
         	(*_pd)[i] = 0;
+        	_used->reset(i);
+            }
         }
 
     private:
         Page_Directory * _pd;
         bool _free;
+        Bitmap<PD_ENTRIES> * _used;
     };
 
     // DMA_Buffer
@@ -310,6 +560,8 @@ public:
             List::Element * e = _free.search_decrementing(frames);
             if(e)
         	phy = e->object() + e->size();
+            else if((frames == 1) && !_zeroed.empty()) // last resort: the pre-zeroed pool
+        	phy = _zeroed.remove()->object();
             else
         	db<IA32_MMU>(WRN) << "IA32_MMU::alloc() failed!" << endl;
         }
@@ -319,10 +571,57 @@ public:
         return phy;
     }
 
+    // Allocates "frames" contiguous frames starting at a multiple of "align" frames
+    static Phy_Addr alloc(unsigned int frames, unsigned int align) {
+        Phy_Addr phy = alloc(frames + align - 1);
+
+        if(phy) {
+            Phy_Addr aligned = (phy + align * sizeof(Frame) - 1) & ~(align * sizeof(Frame) - 1);
+            unsigned int head = (aligned - phy) / sizeof(Frame);
+            free(phy, head);
+            free(aligned + frames * sizeof(Frame), align - 1 - head);
+            phy = aligned;
+        }
+
+        db<IA32_MMU>(TRC) << "IA32_MMU::alloc(frames=" << frames << ",align=" << align << ") => " << phy << endl;
+
+        return phy;
+    }
+
+    // Page colouring (see Traits<IA32_MMU>::colouring)
+    static unsigned int colour(Phy_Addr frame) { return (indexes(frame) >> PAGE_SHIFT) & (COLOURS - 1); }
+
+    // The n-th colour of the budget (modulo its size), so consecutive pages get different colours
+    static unsigned int budget_colour(unsigned int n) {
+        unsigned int b = _budget;
+        for(n %= _budget_size; n; n--)
+            b &= b - 1;
+        return __builtin_ctz(b);
+    }
+
+    // The colours the frames of new pages are taken from (Task::activate() installs each task's budget)
+    static unsigned int budget() { return _budget; }
+    static void budget(unsigned int colours) {
+        _budget = (colours & ALL_COLOURS) ? (colours & ALL_COLOURS) : ALL_COLOURS;
+        _budget_size = __builtin_popcount(_budget);
+    }
+
+    // Allocates a frame of the given colour (any frame, counted as a miss, if none is left)
+    static Phy_Addr alloc_coloured(unsigned int colour);
+    static unsigned int colour_misses() { return _colour_misses; }
+
     static Phy_Addr calloc(unsigned int frames = 1) {
-        Phy_Addr phy = alloc(frames);
+        if((frames == 1) && !_zeroed.empty()) {
+            Phy_Addr phy = _zeroed.remove()->object();
+            memset(phy2log(phy), 0, sizeof(Zeroed_List::Element)); // the only dirty bytes
+            _zeroed_hits++;
+            return phy;
+        }
+        _zeroed_misses++;
 
-        memset(phy2log(phy), 0, sizeof(Frame) * frames);
+        Phy_Addr phy = alloc(frames);
+        if(phy)
+            memset(phy2log(phy), 0, sizeof(Frame) * frames);
 
         return phy;	
     }
@@ -348,16 +647,81 @@ public:
 
     static Phy_Addr physical(Log_Addr addr) {
         Page_Directory * pd = current();
-        Page_Table * pt = (*pd)[directory(addr)];
+        PD_Entry pde = (*pd)[directory(addr)];
+        if(pde & IA32_Flags::PS)
+            return (pde & ~(LARGE_PAGE_SIZE - 1)) | (addr & (LARGE_PAGE_SIZE - 1));
+        Page_Table * pt = pde;
         return (*pt)[page(addr)] | offset(addr);
     }
 
+    // Resolves a page fault on a page reserved by a lazy chunk (by mapping a zeroed frame to it)
+    // or on a copy-on-write page (by giving the writer a private copy)
+    static bool fault(Log_Addr addr);
+
+    // Frame sharing (copy-on-write): share() adds a mapping to a frame, unshare() removes
+    // one and returns false if the frame was not shared, release() frees it with its last mapping
+    static bool share(Phy_Addr frame) {
+        unsigned int i = indexes(frame) >> PAGE_SHIFT;
+        if(!_refs || (i >= _frames))
+            return false;
+        CPU::finc(_refs[i]);
+        return true;
+    }
+
+    static bool unshare(Phy_Addr frame) {
+        unsigned int i = indexes(frame) >> PAGE_SHIFT;
+        if(!_refs || (i >= _frames))
+            return false;
+        for(unsigned int r = _refs[i]; r; r = _refs[i])
+            if(CPU::cas(_refs[i], r, r - 1) == r)
+                return true;
+        return false;
+    }
+
+    static void release(Phy_Addr frame) {
+        if(!unshare(frame))
+            free(frame);
+    }
+
+    // Zeroes one more frame for the pool used by calloc(), returning false when there is nothing to do
+    // (called by the idle thread, thus the list manipulations with interrupts disabled)
+    static bool prezero() {
+        if(_zeroed.size() >= Traits<IA32_MMU>::zeroed_frames)
+            return false;
+
+        CPU::int_disable();
+        List::Element * e = _free.search_decrementing(1);
+        CPU::int_enable();
+        if(!e)
+            return false;
+
+        Phy_Addr phy = e->object() + e->size();
+        memset(phy2log(phy), 0, sizeof(Frame));
+
+        CPU::int_disable();
+        _zeroed.insert(new (phy2log(phy)) Zeroed_List::Element(reinterpret_cast<Frame *>((unsigned int)phy)));
+        CPU::int_enable();
+
+        return true;
+    }
+
+    static unsigned int zeroed_hits() { return _zeroed_hits; }
+    static unsigned int zeroed_misses() { return _zeroed_misses; }
+
     static void flush_tlb() {
         ASM("movl %cr3,%eax");
         ASM("movl %eax,%cr3");
     }
     static void flush_tlb(Log_Addr addr) {
-        ASM("invlpg %0" : : "m"(addr));
+        ASM("invlpg (%0)" : : "r"((unsigned int)addr) : "memory");
+    }
+    // Page by page for short ranges, the whole TLB (but global pages) otherwise
+    static void flush_tlb(Log_Addr from, Log_Addr to) {
+        if(pages(to - from) > FLUSH_PAGES)
+            flush_tlb();
+        else
+            for(Log_Addr addr = from; addr < to; addr += sizeof(Page))
+                flush_tlb(addr);
     }
 
 private:
@@ -367,7 +731,16 @@ private:
 
 private:
     static List _free;
+    static Zeroed_List _zeroed;
+    static unsigned int _zeroed_hits;
+    static unsigned int _zeroed_misses;
     static Page_Directory * _master;
+    static Bitmap<PD_ENTRIES> _master_used;
+    static volatile unsigned int * _refs;
+    static unsigned int _frames;
+    static unsigned int _budget;
+    static unsigned int _budget_size;
+    static unsigned int _colour_misses;
 };
 
 __END_SYS
@@ -13,14 +13,20 @@ template<> struct Traits<IA32>: public Traits<void>
     static const unsigned int WORD_SIZE         = 32;
     static const unsigned int CLOCK             = 2000000000;
     static const bool unaligned_memory_access   = true;
-};
 
-template<> struct Traits<IA32_TSC>: public Traits<void>
-{
+    // Fill stacks with a pattern at creation so their high-water mark can be measured
+    // (it touches every page, so lazily grown stacks become fully resident)
+    static const bool paint_stacks              = false;
+
+    // Save FPU/MMX/SSE state, lazily, for the threads that use it (single-core only; CPUs without FXSAVE/SSE are
+    // detected and left as if it were off, i.e. those instructions terminate the thread that issues them)
+    static const bool fpu                       = true;
 };
 
-template<> struct Traits<IA32_MMU>: public Traits<void>
+template<> struct Traits<IA32_TSC>: public Traits<void>
 {
+    // Serialized time stamps with rdtscp instead of lfence + rdtsc (the CPU must support it)
+    static const bool rdtscp = false;
 };
 
 template<> struct Traits<IA32_PMU>: public Traits<void>
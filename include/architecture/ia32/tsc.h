@@ -10,10 +10,36 @@ __BEGIN_SYS
 
 class IA32_TSC: private TSC_Common
 {
+    friend class IA32;
+
+private:
+    static const bool rdtscp = Traits<IA32_TSC>::rdtscp;
+
 public:
     using TSC_Common::Hertz;
     using TSC_Common::Time_Stamp;
 
+    typedef unsigned long long Nanosecond;
+    typedef unsigned long long Microsecond;
+
+private:
+    // Time stamps are converted with a multiplication and a shift (no 64-bit divisions) by factors computed at init()
+    struct Scale
+    {
+        void set(Hertz from, unsigned long to);
+
+        unsigned long long operator()(const Time_Stamp & ts) const {
+            unsigned long long hi = static_cast<unsigned long long>(static_cast<unsigned long>(ts >> 32)) * mult;
+            unsigned long long lo = static_cast<unsigned long long>(static_cast<unsigned long>(ts)) * mult;
+            if(shift <= 32)
+                return (hi << (32 - shift)) + (lo >> shift);
+            return (hi >> (shift - 32)) + (lo >> shift); // truncates twice, so it might be one short
+        }
+
+        unsigned long mult;
+        unsigned int shift;
+    };
+
 public:
     IA32_TSC() {}
 
@@ -24,6 +50,30 @@ public:
         ASM("rdtsc" : "=A" (ts) : ); // must be volatile!
         return ts;
     }
+
+    // Not taken before the preceding instructions have completed (rdtscp, or rdtsc behind lfence)
+    static Time_Stamp serialized_time_stamp() {
+        Time_Stamp ts;
+        if(rdtscp)
+            ASM("rdtscp" : "=A" (ts) : : "ecx", "memory");
+        else
+            ASM("lfence; rdtsc" : "=A" (ts) : : "memory");
+        return ts;
+    }
+
+    static Nanosecond ns(const Time_Stamp & ts) { return _ns(ts); }
+    static Microsecond us(const Time_Stamp & ts) { return _us(ts); }
+
+    // Cost of a pair of serialized_time_stamp(), to be discounted from short measurements
+    static Time_Stamp overhead() { return _overhead; }
+
+private:
+    static void init();
+
+private:
+    static Scale _ns;
+    static Scale _us;
+    static Time_Stamp _overhead;
 };
 
 __END_SYS
@@ -0,0 +1,103 @@
+// EPOS Zero-copy Inter-Task Communication Channel Abstraction Declarations
+
+#ifndef __channel_h
+#define __channel_h
+
+#include <shared_segment.h>
+#include <semaphore.h>
+
+__BEGIN_SYS
+
+// A unidirectional channel whose message buffers live in a Shared_Segment
+// attached to both ends. Buffers are identified by their offset in the
+// segment, so they are passed (not copied) from the sender to the receiver
+// through a lock-free single-producer/single-consumer ring. A Semaphore
+// rings the receiver's doorbell and another one accounts for free buffers.
+class Channel
+{
+public:
+    typedef CPU::Log_Addr Log_Addr;
+
+    enum End {
+        SENDER,
+        RECEIVER
+    };
+
+private:
+    struct Descriptor
+    {
+        unsigned int offset;
+        unsigned int size;
+    };
+
+    // Lives in the shared segment, thus no pointers
+    struct Ring
+    {
+        void put(unsigned int n, const Descriptor & d) {
+            slot[tail % n] = d;
+            ASM("" : : : "memory"); // the slot must be visible before the tail moves
+            tail = tail + 1;
+        }
+
+        Descriptor get(unsigned int n) {
+            Descriptor d = slot[head % n];
+            ASM("" : : : "memory");
+            head = head + 1;
+            return d;
+        }
+
+        volatile unsigned int head;
+        volatile unsigned int tail;
+        Descriptor slot[1];
+    };
+
+public:
+    Channel(unsigned int buffers = 16, unsigned int buffer_size = 4096);
+    ~Channel();
+
+    Log_Addr attach(End end, Address_Space * as); // 0 on failure (e.g. for a channel without buffers)
+    void detach(End end);
+
+    // Sender
+    void * alloc();
+    void send(void * buffer, unsigned int size);
+
+    // Receiver
+    void * receive(unsigned int * size);
+    void release(void * buffer);
+
+    unsigned int buffers() const { return _buffers; }
+    unsigned int buffer_size() const { return _buffer_size; }
+
+private:
+    // Segment layout: the message ring, the free buffer ring and then the buffers, all cache-line aligned
+    static unsigned int ring_size(unsigned int buffers) {
+        return (sizeof(Ring) + (buffers ? buffers - 1 : 0) * sizeof(Descriptor) + 63) & ~63;
+    }
+
+    Ring * ring(End end, unsigned int i) const {
+        return reinterpret_cast<Ring *>(_base[end] + i * _ring_size);
+    }
+
+    void * buffer(End end, const Descriptor & d) const {
+        return reinterpret_cast<void *>(_base[end] + d.offset);
+    }
+
+    unsigned int offset(End end, void * buffer) const {
+        return reinterpret_cast<char *>(buffer) - _base[end];
+    }
+
+private:
+    unsigned int _buffers;
+    unsigned int _buffer_size;
+    unsigned int _ring_size;
+    Shared_Segment _segment;
+    Semaphore _full;
+    Semaphore _empty;
+    Address_Space * _as[2];
+    char * _base[2];
+};
+
+__END_SYS
+
+#endif
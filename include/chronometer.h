@@ -23,19 +23,19 @@ public:
     Hertz frequency() { return tsc.frequency(); }
 
     void reset() { _start = 0; _stop = 0; }
-    void start() { if(_start == 0) _start = tsc.time_stamp(); }
-    void lap() { if(_start != 0) _stop = tsc.time_stamp(); }
+    void start() { if(_start == 0) _start = tsc.serialized_time_stamp(); }
+    void lap() { if(_start != 0) _stop = tsc.serialized_time_stamp(); }
     void stop() { lap(); }
 
-    Microsecond read() { return ticks() * 1000000 / frequency(); }
+    Microsecond read() { return tsc.us(ticks()); }
 
 private:
+    // Discounts the cost of taking the time stamps themselves (see TSC::overhead())
     Time_Stamp ticks() {
         if(_start == 0)
             return 0;
-        if(_stop == 0)
-            return tsc.time_stamp() - _start;
-        return _stop - _start;
+        Time_Stamp t = ((_stop == 0) ? tsc.serialized_time_stamp() : _stop) - _start;
+        return (t > tsc.overhead()) ? t - tsc.overhead() : 0;
     }
 
 private:
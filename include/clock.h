@@ -3,6 +3,7 @@
 #ifndef __clock_h
 #define __clock_h
 
+#include <tsc.h>
 #include <rtc.h>
 
 __BEGIN_SYS
@@ -10,16 +11,18 @@ __BEGIN_SYS
 class Clock
 {
 public:
-    typedef RTC::Microsecond Microsecond;
+    typedef TSC::Nanosecond Nanosecond;
     typedef RTC::Second Second;
     typedef RTC::Date Date;
 
 public:
     Clock() {}
 
-    Microsecond resolution() { return 1000000; }
+    // Nanoseconds per TSC tick (rounded up)
+    Nanosecond resolution() { return 1000000000UL / TSC::frequency() + ((1000000000UL % TSC::frequency()) ? 1 : 0); }
 
-    Second now() { return RTC::seconds_since_epoch(); }
+    // Nanoseconds since the TSC was reset (i.e. since boot), without touching the RTC
+    Nanosecond now() { return TSC::ns(TSC::time_stamp()); }
 
     Date date() { return RTC::date(); }
     void date(const Date & d) { return RTC::date(d); }
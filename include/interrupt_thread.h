@@ -0,0 +1,53 @@
+// EPOS Threaded Interrupt Handler Abstraction Declarations
+
+#ifndef __interrupt_thread_h
+#define __interrupt_thread_h
+
+#include <ic.h>
+#include <thread.h>
+#include <semaphore.h>
+
+__BEGIN_SYS
+
+// Runs an interrupt handler in a kernel thread of its own, so it is scheduled (and preempted) according to
+// its priority instead of delaying every other interrupt. The hard ISR only masks the interrupt and wakes the
+// thread up, which calls the handler and then unmasks the interrupt.
+class Interrupt_Thread
+{
+public:
+    typedef IC::Interrupt_Id Interrupt_Id;
+    typedef IC::Interrupt_Handler Interrupt_Handler;
+    typedef Thread::Criterion Criterion;
+
+public:
+    Interrupt_Thread(const Interrupt_Id & i, const Interrupt_Handler & h, const Criterion & priority = Thread::HIGH);
+    ~Interrupt_Thread();
+
+    const Interrupt_Id & id() const { return _id; }
+    unsigned int count() const { return _count; }
+
+private:
+    static void isr(const Interrupt_Id & i);
+    static int run(Interrupt_Thread * it);
+
+    // On multicores, device lines are masked at the I/O APIC, but the timer and the IPIs belong to the local APIC
+    static bool maskable(const Interrupt_Id & i) {
+        return (i >= IC::INT_FIRST_HARD) && (i <= IC::INT_LAST_HARD)
+            && (!Traits<System>::multicore || ((i != IC::INT_TIMER) && (i != IC::INT_RESCHEDULER)));
+    }
+
+private:
+    Interrupt_Id _id;
+    Interrupt_Handler _handler;
+    Interrupt_Handler _previous;
+    Semaphore _pending;
+    volatile bool _finishing;
+    volatile unsigned int _count;
+    Thread * _thread;
+
+    static Interrupt_Thread * _threads[IC::INTS];
+};
+
+__END_SYS
+
+#endif
@@ -4,6 +4,7 @@
 #define __pc_ic_h
 
 #include <cpu.h>
+#include <tsc.h>
 #include <ic.h>
 #include <machine/pc/memory_map.h>
 
@@ -78,10 +79,36 @@ public:
     static int irq2int(int i) { return i + HARD_INT; }
     static int int2irq(int i) { return i - HARD_INT; }
 
-    static void enable() { imr(1 << IRQ_CASCADE); }
-    static void enable(int i) { imr(imr() & ~(1 << int2irq(i))); }
-    static void disable() { imr(~(1 << IRQ_CASCADE)); }
-    static void disable(int i) { imr(imr() | (1 << int2irq(i))); }
+    // The IMR also reflects the interrupts masked by nesting (see nest()), so the mask asked for is kept in _imr
+    static void enable() { _imr = 1 << IRQ_CASCADE; imr(_imr | _nested); }
+    static void enable(int i) { _imr &= ~(1 << int2irq(i)); imr(_imr | _nested); }
+    static void disable() { _imr = ~(1 << IRQ_CASCADE); imr(_imr | _nested); }
+    static void disable(int i) { _imr |= 1 << int2irq(i); imr(_imr | _nested); }
+
+    // Nested interrupts (see Traits<PC_IC>::nested)
+    typedef Reg16 Nesting;
+
+    static Nesting nesting() { return _nested; }
+    static void nesting(const Nesting & n) {
+        if(n != _nested) {
+            _nested = n;
+            imr(_imr | _nested);
+        }
+    }
+
+    // Masks the IRQs whose priority is not higher than that of "i" (the cascade is left alone)
+    static void nest(int i) {
+        unsigned int p = priority(int2irq(i));
+        Reg16 mask = 0;
+        for(unsigned int irq = 0; irq < IRQS; irq++)
+            if((irq != IRQ_CASCADE) && (priority(irq) >= p))
+                mask |= 1 << irq;
+        nesting(_nested | mask);
+    }
+
+    static unsigned int priority(unsigned int irq) {
+        return (Traits<PC_IC>::priorities >> (irq * 4)) & 0xf;
+    }
 
     static void remap(Reg8 base = HARD_INT) {
         Reg8 m_imr = CPU::in8(MASTER_DAT);      // save IMRs
@@ -143,6 +170,121 @@ public:
     }
 
     static void ipi_send(int dest, int interrupt) {}
+
+    static void route(int i, unsigned int cpus) {}
+    static unsigned int route(int i) { return 1; }
+
+private:
+    static Reg16 _imr;
+    static volatile Reg16 _nested;
+};
+
+// Intel 82093AA I/O APIC (routes device interrupts to the local APICs on multiprocessors)
+class IO_APIC
+{
+private:
+    typedef CPU::Reg32 Reg32;
+    typedef CPU::Log_Addr Log_Addr;
+
+public:
+    // Default mapping addresses
+    enum {
+        IO_APIC_PHY_ADDR	= 0xfec00000,
+        IO_APIC_LOG_ADDR	= Memory_Map<PC>::IO_APIC
+    };
+
+    // Memory-mapped registers (the others are accessed indirectly through them)
+    enum {
+        IOREGSEL =		0x00,	// Register select
+        IOWIN =			0x10	// Register window
+    };
+
+    // Indirect registers
+    enum {
+        ID =			0x00,	// Identification
+        VERSION =		0x01,	// Version and number of pins
+        ARB =			0x02,	// Arbitration
+        REDIRECTION =		0x10	// Redirection table (2 registers per pin)
+    };
+
+    // Redirection Table Entry (64 bits, with the destination in the upper half)
+    enum {
+        RTE_FIXED		= (0 << 8),
+        RTE_LOWPRI		= (1 << 8),
+        RTE_PHY			= (0 << 11),
+        RTE_LOG			= (1 << 11),
+        RTE_HIGH		= (0 << 13),
+        RTE_LOW			= (1 << 13),
+        RTE_EDGE		= (0 << 15),
+        RTE_LEVEL		= (1 << 15),
+        RTE_MASKED		= (1 << 16),
+        RTE_DEST_SHIFT		= 24
+    };
+
+public:
+    IO_APIC() {}
+
+    static void remap(Log_Addr addr = IO_APIC_LOG_ADDR) {
+        _base = addr;
+    }
+
+    static Reg32 read(unsigned int reg) {
+        *static_cast<volatile Reg32 *>(_base + IOREGSEL) = reg;
+        return *static_cast<volatile Reg32 *>(_base + IOWIN);
+    }
+    static void write(unsigned int reg, Reg32 v) {
+        *static_cast<volatile Reg32 *>(_base + IOREGSEL) = reg;
+        *static_cast<volatile Reg32 *>(_base + IOWIN) = v;
+    }
+
+    static unsigned int pins() {
+        return ((read(VERSION) >> 16) & 0xff) + 1;
+    }
+
+    // Legacy (ISA) IRQs are assumed to be wired to the pins of the same number,
+    // edge-triggered and active high, as MP tables usually report
+    static void reset(unsigned int base) {
+        for(unsigned int pin = 0; pin < pins(); pin++) {
+            write(REDIRECTION + 2 * pin + 1, 0 << RTE_DEST_SHIFT); // the bootstrap CPU
+            write(REDIRECTION + 2 * pin, RTE_MASKED | RTE_EDGE | RTE_HIGH | RTE_PHY | RTE_FIXED | (base + pin));
+        }
+    }
+
+    static void mask(unsigned int pin) {
+        write(REDIRECTION + 2 * pin, read(REDIRECTION + 2 * pin) | RTE_MASKED);
+    }
+    static void unmask(unsigned int pin) {
+        write(REDIRECTION + 2 * pin, read(REDIRECTION + 2 * pin) & ~RTE_MASKED);
+    }
+
+    // Routes a pin to a set of CPUs (bit n stands for the CPU whose local APIC ID is n)
+    // A single CPU is addressed physically; a set is addressed logically (flat model, see APIC::reset())
+    // with lowest priority delivery, so the least busy CPU in the set takes each interrupt
+    static void route(unsigned int pin, unsigned int cpus) {
+        Reg32 low = read(REDIRECTION + 2 * pin) & (RTE_MASKED | RTE_LEVEL | RTE_LOW | 0xff);
+        Reg32 dest;
+        if(!(cpus & (cpus - 1))) {
+            unsigned int cpu = 0;
+            while(cpus >>= 1)
+                cpu++;
+            low |= RTE_PHY | RTE_FIXED;
+            dest = cpu;
+        } else {
+            low |= RTE_LOG | RTE_LOWPRI;
+            dest = cpus & 0xff;
+        }
+        write(REDIRECTION + 2 * pin, RTE_MASKED); // do not deliver while half written
+        write(REDIRECTION + 2 * pin + 1, dest << RTE_DEST_SHIFT);
+        write(REDIRECTION + 2 * pin, low);
+    }
+
+    static unsigned int route(unsigned int pin) {
+        Reg32 dest = read(REDIRECTION + 2 * pin + 1) >> RTE_DEST_SHIFT;
+        return (read(REDIRECTION + 2 * pin) & RTE_LOG) ? dest : (1 << dest);
+    }
+
+private:
+    static Log_Addr _base;
 };
 
 // Intel IA-32 APIC (internal, not tested with 82489DX)
@@ -158,12 +300,13 @@ private:
 
 public:
     // Interrupts
-    static const unsigned int INTS = i8259A::INTS;
+    // The local timer gets a vector above the devices' group of 16, so it is not blocked by them when nesting (see nest())
+    static const unsigned int INTS = i8259A::INTS + 1;
     enum {
         INT_FIRST_HARD  = i8259A::INT_FIRST_HARD,
-        INT_TIMER	= i8259A::INT_TIMER,
-        INT_RESCHEDULER = i8259A::INT_RESCHEDULER, // in multicores, reschedule goes via IPI, which must be acknowledged just like hardware
-        INT_SYSCALL     = i8259A::INT_SYSCALL,
+        INT_TIMER	= i8259A::INT_RESCHEDULER,
+        INT_RESCHEDULER = INT_TIMER + 1, // in multicores, cross-CPU calls go via IPI, which must be acknowledged just like hardware
+        INT_SYSCALL     = INT_RESCHEDULER + 1,
         INT_LAST_HARD   = INT_RESCHEDULER
     };
 
@@ -171,8 +314,8 @@ public:
     enum {
         LOCAL_APIC_PHY_ADDR	= 0xfee00000,
         LOCAL_APIC_LOG_ADDR	= Memory_Map<PC>::APIC,
-        IO_APIC_PHY_ADDR	= 0xfec00000,
-        IO_APIC_LOG_ADDR	= Memory_Map<PC>::APIC + (IO_APIC_PHY_ADDR - LOCAL_APIC_PHY_ADDR)
+        IO_APIC_PHY_ADDR	= IO_APIC::IO_APIC_PHY_ADDR,
+        IO_APIC_LOG_ADDR	= IO_APIC::IO_APIC_LOG_ADDR
     };
 
     // Memory-mapped registers
@@ -303,6 +446,7 @@ public:
 
     static void remap(Log_Addr addr = LOCAL_APIC_LOG_ADDR) {
         _base = addr;
+        IO_APIC::remap();
     }
 
     static void enable() {
@@ -310,14 +454,40 @@ public:
         v |= SVR_APIC_ENABLED;
         write(SVR, v);
     }
-    static void enable(int i) { enable(); }
+    static void enable(int i) {
+        enable();
+        if(io(i))
+            IO_APIC::unmask(int2irq(i));
+    }
 
     static void disable() {
         Reg32 v  = read(SVR);
         v &= ~SVR_APIC_ENABLED;
         write(SVR, v);
     }
-    static void disable(int i) { disable(); }
+    static void disable(int i) {
+        if(io(i))
+            IO_APIC::mask(int2irq(i));
+        else
+            disable();
+    }
+
+    // Device interrupts come through the I/O APIC; the timer is the local one
+    static void route(int i, unsigned int cpus) {
+        if(io(i))
+            IO_APIC::route(int2irq(i), cpus);
+    }
+    static unsigned int route(int i) {
+        return io(i) ? IO_APIC::route(int2irq(i)) : (1 << id());
+    }
+
+    // Nested interrupts (see Traits<PC_IC>::nested): the TPR blocks all vectors in the same group of 16 or below,
+    // so device handlers block each other, but not the timer and the IPIs, which are in the group above
+    typedef Reg32 Nesting;
+
+    static Nesting nesting() { return read(TPR); }
+    static void nesting(const Nesting & n) { write(TPR, n); }
+    static void nest(int i) { write(TPR, i & 0xf0); }
 
     static Reg32 read(unsigned int reg) {
         return *static_cast<volatile Reg32 *>(_base + reg);
@@ -344,6 +514,9 @@ public:
         remap(addr);
         if(Traits<System>::multicore) {
             clear();
+            // Flat logical destinations (one bit per CPU), so the I/O APIC can address sets of CPUs
+            write(DFR, 0xffffffff);
+            write(LDR, (1 << id()) << ID_SHIFT);
             enable();
             connect();
         } else
@@ -383,6 +556,8 @@ public:
     }
 
 private:
+    static bool io(int i) { return (i > int(i8259A::INT_TIMER)) && (i <= int(i8259A::INT_LAST_HARD)); }
+
     static int maxlvt()	{
         Reg32 v = read(VERSION);
         // 82489DXs do not report # of LVT entries
@@ -452,12 +627,50 @@ private:
 public:
     using IC_Common::Interrupt_Id;
     using IC_Common::Interrupt_Handler;
+    using Engine::INTS;
+    using Engine::INT_FIRST_HARD;
+    using Engine::INT_LAST_HARD;
     using Engine::INT_TIMER;
     using Engine::INT_RESCHEDULER;
     using Engine::INT_SYSCALL;
 
     using Engine::ipi_send;
 
+    // Nested interrupts (see Traits<PC_IC>::nested)
+    static const bool nested = Traits<PC_IC>::nested;
+    typedef Engine::Nesting Nesting;
+
+    // Cross-CPU calls
+    typedef void (Call)(void *);
+    static const unsigned int CALLS = 16; // requests that can be pending for each CPU
+
+    // Interrupt statistics (see Traits<PC_IC>::statistics)
+    static const bool statistics = Traits<PC_IC>::statistics;
+    static const unsigned int BUCKETS = 16;
+
+    // Durations in TSC cycles: bucket 0 counts those under 128 cycles, bucket n those in [2^(n+6), 2^(n+7))
+    // and the last one everything longer
+    struct Histogram
+    {
+        void add(unsigned long cycles) {
+            unsigned int b = 0;
+            for(unsigned long c = cycles >> 7; c && (b < BUCKETS - 1); c >>= 1)
+                b++;
+            bucket[b]++;
+            if(cycles > max)
+                max = cycles;
+        }
+
+        unsigned int bucket[BUCKETS];
+        unsigned long max;
+    };
+
+    struct Statistics
+    {
+        unsigned int count;
+        Histogram duration; // until the handler returns or switches threads (see switching())
+    };
+
 public:
     PC_IC() {}
 
@@ -491,23 +704,99 @@ public:
         Engine::disable(i);
     }
 
+    // Device interrupts can be routed to a CPU, or to a set of CPUs (bit n = CPU n) of which the least busy
+    // takes each one (only on multicores, where the I/O APIC is used; otherwise they always go to CPU 0)
+    // For now, the scheduler keeps a single chosen thread, CPU 0's, so any handler that reaches it (e.g. through
+    // Alarm or Semaphore::v(), as Interrupt_Thread does) would corrupt CPU 0's thread if run elsewhere: until it
+    // has one per CPU, sets other than CPU 0 alone are refused
+    static bool affinity(const Interrupt_Id & i, unsigned int cpu) {
+        return affinity_set(i, 1 << cpu);
+    }
+
+    static bool affinity_set(const Interrupt_Id & i, unsigned int cpus) {
+        db<IC>(TRC) << "IC::affinity(int=" << i << ",cpus=" << hex << cpus << dec << ")" << endl;
+
+        if(cpus != 1) {
+            db<IC>(WRN) << "IC::affinity: interrupts can only go to CPU 0!" << endl;
+            return false;
+        }
+
+        Engine::route(i, cpus);
+        return true;
+    }
+
+    static unsigned int affinity_set(const Interrupt_Id & i) {
+        return Engine::route(i);
+    }
+
+    // Runs "f(arg)" on each CPU in "cpus" (bit n = CPU n), waiting for all of them to acknowledge it if "wait" is set
+    // Requests are queued at each target, which is only interrupted (with INT_RESCHEDULER) when its queue was empty,
+    // so requests issued in a row are served by a single IPI
+    static void call(unsigned int cpus, Call * f, void * arg, bool wait = true);
+
+    // The mask due to the handlers being run, which the scheduler must not carry from one thread to another
+    static Nesting nesting() { return Engine::nesting(); }
+    static void nesting(const Nesting & n) { Engine::nesting(n); }
+
+    static const Statistics & stats(const Interrupt_Id & i) { return _stats[i]; }
+    static const Histogram & wakeup_latency() { return _wakeup; }
+    static void dump_stats();
+
+    // Whether Traits<PC_IC>::statistics_dump seconds have passed since the last time it was asked (the timer handler
+    // only counts them, the statistics are printed by the idle thread, so printing doesn't inflate them)
+    static bool dump_due() {
+        bool due = _dump_due;
+        _dump_due = false;
+        return due;
+    }
+
+    // Called by the scheduler right before switching threads, so the interrupts being handled are charged until
+    // then instead of until the thread they interrupted resumes
+    static void switching();
+
+    // Called by the scheduler as a thread resumes, to account for the time since the last timer interrupt
+    static void wakeup() {
+        if(statistics && _timer_stamp) {
+            _wakeup.add(TSC::time_stamp() - _timer_stamp);
+            _timer_stamp = 0;
+        }
+    }
+
     using Engine::eoi;
     using Engine::irq2int;
     using Engine::int2irq;
 
 private:
     static void dispatch(unsigned int i) {
+        Frame frame;
+        if(statistics)
+            enter(&frame, i);
+
         bool not_spurious = true;
         if((i >= INT_FIRST_HARD) && (i <= INT_LAST_HARD))
             not_spurious = eoi(i);
         if(not_spurious) {
             if((i != INT_TIMER) || Traits<IC>::hysterically_debugged)
                 db<IC>(TRC) << "IC::dispatch(i=" << i << ")" << endl;
-            _int_vector[i](i);
+            if(nested && (i >= INT_FIRST_HARD) && (i <= INT_LAST_HARD)) {
+                // Let more urgent interrupts preempt this handler
+                Nesting n = nesting();
+                Engine::nest(i);
+                CPU::int_enable();
+                _int_vector[i](i);
+                CPU::int_disable();
+                nesting(n);
+            } else
+                _int_vector[i](i);
         } else {
+            if(statistics)
+                frame.start = 0; // not accounted for
             if(i != INT_LAST_HARD)
                 db<IC>(TRC) << "IC::spurious interrupt (" << i << ")" << endl;
         }
+
+        if(statistics)
+            leave(&frame);
     }
 
     static void entry();
@@ -518,10 +807,59 @@ private:
     static void exc_gpf(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Reg32 eflags);
     static void exc_fpu(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Reg32 eflags);
 
+    // With lazy thread stacks, page faults run as a separate (hardware) task, with a stack of their own
+    static void entry_pf_task();
+    static void exc_pf_task(Reg32 error);
+    static void pf_exit();
+
+    // Interrupts being handled on each CPU, the innermost first, each in a Frame on the stack of the thread it interrupted
+    struct Frame
+    {
+        unsigned int i;
+        TSC::Time_Stamp start; // 0 once accounted for
+        Frame * outer;
+    };
+
+    static void enter(Frame * f, unsigned int i);
+    static void leave(Frame * f);
+    static void account(unsigned int i, unsigned long cycles);
+
+    static void int_call(const Interrupt_Id & i);
+    static void serve();
+    static void post(unsigned int cpu, Call * f, void * arg, volatile unsigned int * ack);
+
     static void init();
 
 private:
     static Interrupt_Handler _int_vector[INTS];
+    static Statistics _stats[INTS];
+    static Histogram _wakeup;
+    static volatile TSC::Time_Stamp _timer_stamp;
+    static unsigned int _ticks;
+    static volatile bool _dump_due;
+    static Frame * _frames[Traits<Machine>::CPUS];
+
+    struct Request
+    {
+        Call * function;
+        void * arg;
+        volatile unsigned int * ack;
+    };
+
+    struct Mailbox
+    {
+        volatile bool lock;
+        volatile unsigned int head;
+        volatile unsigned int tail;
+        Request request[CALLS];
+    };
+
+    static Mailbox _mailbox[Traits<Machine>::CPUS];
+
+    // Only one page fault task (it is busy while it runs), thus single-core only
+    static const bool pf_task = Traits<Thread>::lazy_stacks && !Traits<System>::multicore;
+    static CPU::TSS _pf_tss;
+    static char _pf_stack[4096];
 };
 
 __END_SYS
@@ -59,6 +59,20 @@ template<> struct Traits<PC_PCI>: public Traits<PC_Common>
 template<> struct Traits<PC_IC>: public Traits<PC_Common>
 {
     static const bool debugged = hysterically_debugged;
+
+    // Count interrupts and histogram their handlers' durations and the latency from
+    // a timer interrupt to the thread it wakes up (see IC::stats())
+    static const bool statistics = false;
+    static const unsigned int statistics_dump = 0; // print them (from the idle thread) every so many seconds (0 = never)
+
+    // Nested interrupts: handlers run with interrupts enabled, but with those of equal or lower priority masked
+    static const bool nested = false;
+
+    // Priority of each IRQ, one nibble per IRQ starting from IRQ 0 at the least significant one (0 is the highest)
+    // The default is the 8259A's own order: timer, keyboard, the slave's IRQs 8-15 (through the cascade), then 3-7
+    // (only the 8259A honors it; the APIC TPR can only tell vectors apart in groups of 16, so there the timer preempts
+    // every device handler, which can't preempt each other)
+    static const unsigned long long priorities = 0x98765432edcba210ULL;
 };
 
 template<> struct Traits<PC_Timer>: public Traits<PC_Common>
@@ -27,7 +27,8 @@ struct Memory_Map<PC>
         IO =            Traits<PC>::IO_BASE,
         APIC =          IO,
         VGA =           IO +  4 * 1024,
-        PCI =           IO + 68 * 1024,
+        IO_APIC =       IO + 68 * 1024,
+        PCI =           IO + 72 * 1024,
 
         SYS =           Traits<PC>::SYS,
         IDT =           SYS + 0x00000000,
@@ -46,6 +46,8 @@ public:
             CD  = 0x010, // Cache Disable (0=cacheable, 1=non-cacheable)
             CT  = 0x020, // Contiguous (0=non-contiguous, 1=contiguous)
             IO  = 0x040, // Memory Mapped I/O (0=memory, 1=I/O)
+            LARGE = 0x080, // Large Pages (0=small pages, 1=large pages, implies contiguous)
+            LAZY = 0x100, // Demand Paging (0=frames mapped at creation, 1=frames mapped on first touch)
             SYS = (PRE | RW ),
             APP = (PRE | RW | USR)
         };
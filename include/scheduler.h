@@ -30,6 +30,8 @@ namespace Scheduling_Criteria
         static const bool dynamic = false;
         static const bool preemptive = true;
 
+        static const unsigned int QUEUES = 1;
+
     public:
         Priority(int p = NORMAL): _priority(p) {}
 
@@ -5,20 +5,34 @@
 
 #include <utility/heap.h>
 #include <segment.h>
+#include <system.h>
 
 __BEGIN_SYS
 
 class Scratchpad_Common
 {
-    friend void * ::operator new(size_t, const EPOS::Scratchpad_Allocator &);
-    friend void * ::operator new[](size_t, const EPOS::Scratchpad_Allocator &);
-
 public:
-    static void * alloc(unsigned int bytes) { return _heap->alloc(bytes); }
+    // Falls back to the system heap when there is no scratchpad or it is full
+    static void * alloc(unsigned int bytes);
+
+    static bool contains(const void * ptr) {
+        return _heap && (reinterpret_cast<const char *>(ptr) >= _base) && (reinterpret_cast<const char *>(ptr) < _base + _heap->capacity());
+    }
+
+    // Usage statistics
+    static unsigned int size() { return _heap ? _heap->capacity() : 0; }
+    static unsigned int used() { return _heap ? _heap->allocated() : 0; }
+    static unsigned int peak() { return _peak; }
+    static unsigned int allocations() { return _allocations; }
+    static unsigned int misses() { return _misses; }
 
 protected:
     static Segment * _segment;
     static Heap * _heap;
+    static char * _base;
+    static unsigned int _peak;
+    static unsigned int _allocations;
+    static unsigned int _misses;
 };
 
 __END_SYS
@@ -27,11 +41,11 @@ __END_SYS
 #include __SCRATCHPAD_H
 
 inline void * operator new(size_t bytes, const EPOS::Scratchpad_Allocator & allocator) {
-    return _SYS::Scratchpad::_heap->alloc(bytes);
+    return _SYS::Scratchpad::alloc(bytes);
 }
 
 inline void * operator new[](size_t bytes, const EPOS::Scratchpad_Allocator & allocator) {
-    return _SYS::Scratchpad::_heap->alloc(bytes);
+    return _SYS::Scratchpad::alloc(bytes);
 }
 
 #endif
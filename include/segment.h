@@ -21,9 +21,18 @@ public:
     Segment(Phy_Addr phy_addr, unsigned int bytes, Flags flags = Flags::APP);
     ~Segment();
 
+    Segment * clone_cow() const; // 0 when out of memory or for device memory
+
     unsigned int size() const;
+    unsigned int resident() const;
+    unsigned int resident(unsigned int offset, unsigned int bytes) const;
     Phy_Addr phy_address() const;
     int resize(int amount);
+    void guard(unsigned int offset = 0);
+    void discard(unsigned int offset, unsigned int bytes);
+
+private:
+    Segment(const Segment & segment, bool cow);
 };
 
 __END_SYS
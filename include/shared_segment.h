@@ -0,0 +1,32 @@
+// EPOS Shared Memory Segment Abstraction Declarations
+
+#ifndef __shared_segment_h
+#define __shared_segment_h
+
+#include <segment.h>
+#include <address_space.h>
+
+__BEGIN_SYS
+
+// A Segment meant to be attached into several address spaces at once
+class Shared_Segment: public Segment
+{
+public:
+    typedef CPU::Log_Addr Log_Addr;
+
+public:
+    Shared_Segment(unsigned int bytes, Flags flags = Flags::APP);
+    ~Shared_Segment();
+
+    Log_Addr attach(Address_Space * as);
+    void detach(Address_Space * as, Log_Addr addr);
+
+    unsigned int attachments() const { return _attachments; }
+
+private:
+    volatile unsigned int _attachments;
+};
+
+__END_SYS
+
+#endif
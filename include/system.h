@@ -12,11 +12,18 @@ class System
 {
     friend class Init_System;
     friend class Init_Application;
+    friend class Thread;
     friend void CPU::Context::load() const volatile;
     friend void * ::malloc(size_t);
     friend void ::free(void *);
+    friend void * ::realloc(void *, size_t);
+    friend void * ::memalign(size_t, size_t);
+    friend void * ::operator new(size_t);
+    friend void * ::operator new[](size_t);
     friend void * ::operator new(size_t, const EPOS::System_Allocator &);
     friend void * ::operator new[](size_t, const EPOS::System_Allocator &);
+    friend void * ::operator new(size_t, const EPOS::System_Allocator &, unsigned int);
+    friend void * ::operator new[](size_t, const EPOS::System_Allocator &, unsigned int);
     friend void ::operator delete(void *);
     friend void ::operator delete[](void *);
 
@@ -35,12 +42,22 @@ private:
 
 __END_SYS
 
-inline void * operator new(size_t bytes, const EPOS::System_Allocator & allocator) {
-    return _SYS::System::_heap->alloc(bytes);
+// Never inlined, so their return address is the allocation site (see Heap::alloc())
+inline __attribute__((noinline)) void * operator new(size_t bytes, const EPOS::System_Allocator & allocator) {
+    return _SYS::System::_heap->alloc(bytes, __builtin_return_address(0));
 }
 
-inline void * operator new[](size_t bytes, const EPOS::System_Allocator & allocator) {
-    return _SYS::System::_heap->alloc(bytes);
+inline __attribute__((noinline)) void * operator new[](size_t bytes, const EPOS::System_Allocator & allocator) {
+    return _SYS::System::_heap->alloc(bytes, __builtin_return_address(0));
+}
+
+// Aligned to a power of two, e.g. new (SYSTEM, 64) to keep per-CPU data in cache lines of its own
+inline __attribute__((noinline)) void * operator new(size_t bytes, const EPOS::System_Allocator & allocator, unsigned int align) {
+    return _SYS::System::_heap->alloc(bytes, align, __builtin_return_address(0));
+}
+
+inline __attribute__((noinline)) void * operator new[](size_t bytes, const EPOS::System_Allocator & allocator, unsigned int align) {
+    return _SYS::System::_heap->alloc(bytes, align, __builtin_return_address(0));
 }
 
 #endif
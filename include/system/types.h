@@ -14,6 +14,8 @@ __END_API
 extern "C"
 {
     void * malloc(size_t);
+    void * realloc(void *, size_t);
+    void * memalign(size_t, size_t);
     void free(void *);
 }
 
@@ -22,6 +24,8 @@ inline void * operator new[](size_t s, void * a) { return a; }
 
 void * operator new(size_t, const EPOS::System_Allocator &);
 void * operator new[](size_t, const EPOS::System_Allocator &);
+void * operator new(size_t, const EPOS::System_Allocator &, unsigned int);
+void * operator new[](size_t, const EPOS::System_Allocator &, unsigned int);
 
 void * operator new(size_t, const EPOS::Scratchpad_Allocator &);
 void * operator new[](size_t, const EPOS::Scratchpad_Allocator &);
@@ -41,6 +45,7 @@ class Observers;
 class Observeds;
 class OStream;
 class Queues;
+class Region;
 class Random;
 class Spin;
 class SREC;
@@ -82,6 +87,7 @@ class System;
 class Application;
 
 class Thread;
+class Interrupt_Thread;
 class Task;
 
 template<typename> class Scheduler;
@@ -102,6 +108,8 @@ namespace Scheduling_Criteria
 
 class Address_Space;
 class Segment;
+class Shared_Segment;
+class Channel;
 
 class Synchronizer;
 class Mutex;
@@ -137,6 +145,7 @@ enum
 
     ADDRESS_SPACE_ID,
     SEGMENT_ID,
+    CHANNEL_ID,
 
     MUTEX_ID,
     SEMAPHORE_ID,
@@ -172,6 +181,8 @@ template<> struct Type<Thread> { static const Type_Id ID = THREAD_ID; };
 
 template<> struct Type<Address_Space> { static const Type_Id ID = ADDRESS_SPACE_ID; };
 template<> struct Type<Segment> { static const Type_Id ID = SEGMENT_ID; };
+template<> struct Type<Shared_Segment> { static const Type_Id ID = SEGMENT_ID; };
+template<> struct Type<Channel> { static const Type_Id ID = CHANNEL_ID; };
 
 template<> struct Type<Mutex> { static const Type_Id ID = MUTEX_ID; };
 template<> struct Type<Semaphore> { static const Type_Id ID = SEMAPHORE_ID; };
@@ -27,6 +27,16 @@ public:
 
 	void insert(Thread * t);
 
+	// Page colours this task's frames are taken from (see Traits<IA32_MMU>::colouring)
+	unsigned int colours() const { return _colours; }
+	void colours(unsigned int budget);
+
+
+private:
+	// Lazily grown thread stacks (see Traits<Thread>::lazy_stacks) are packed into a single Segment
+	// per task, in slots of STACK_SIZE preceded by a guard page
+	static const unsigned int STACK_SLOTS = sizeof(unsigned int) * 8;
+	static const unsigned int STACK_SLOT = Traits<Application>::STACK_SIZE + sizeof(MMU::Page);
 
 private:
 	Task();
@@ -42,6 +52,10 @@ private:
 		_master->_data = CPU::Phy_Addr(Memory_Map<Machine>::APP_DATA);
 	}
 
+	char * alloc_stack();
+	void free_stack(char * stack);
+	unsigned int stack_resident(char * stack) const;
+
 
 private:
 	//Manter uma referência das threads da instância
@@ -50,8 +64,12 @@ private:
 	const Segment * _data_segment;
 	CPU::Phy_Addr _code;
 	CPU::Phy_Addr _data;
+	unsigned int _colours;
+	Segment * _stacks;
+	char * _stacks_base;
+	unsigned int _stacks_used;
 
-	void activate() { _address_space->activate(); };
+	void activate() { _address_space->activate(); MMU::budget(_colours); };
 
 	static Simple_List<Thread> _threads;
 	static Task * _master;
@@ -24,9 +24,15 @@ class Thread
 protected:
     static const bool preemptive = Traits<Thread>::Criterion::preemptive;
     static const bool reboot = Traits<System>::reboot;
+    static const bool smp = Traits<Thread>::smp;
+
+    // The scheduler keeps a single chosen thread, so per-CPU queues (e.g. CPU_Affinity's) would have every CPU
+    // choosing and switching out CPU 0's running thread
+    static_assert(!smp || (Traits<Thread>::Criterion::QUEUES == 1), "Per-CPU scheduling queues need a chosen thread per CPU");
 
     static const unsigned int QUANTUM = Traits<Thread>::QUANTUM;
     static const unsigned int STACK_SIZE = Traits<Application>::STACK_SIZE;
+    static const bool lazy_stacks = Traits<Thread>::lazy_stacks && !Traits<System>::multicore; // a single page fault task
 
     typedef CPU::Log_Addr Log_Addr;
     typedef CPU::Context Context;
@@ -54,14 +60,15 @@ public:
         IDLE    = Criterion::IDLE
     };
 
-    // Thread Configuration
+    // Thread Configuration (the stack can be placed in the Scratchpad, if the machine has one)
     struct Configuration {
-        Configuration(const State & s = READY, const Criterion & c = NORMAL, unsigned int ss = STACK_SIZE)
-        : state(s), criterion(c), stack_size(ss) {}
+        Configuration(const State & s = READY, const Criterion & c = NORMAL, unsigned int ss = STACK_SIZE, bool sp = false)
+        : state(s), criterion(c), stack_size(ss), scratchpad(sp) {}
 
         State state;
         Criterion criterion;
         unsigned int stack_size;
+        bool scratchpad;
     };
 
     // Thread Queue
@@ -88,13 +95,26 @@ public:
     void suspend() { suspend(false); }
     void resume();
 
+    // Stack usage in bytes: current and high-water mark (exact with Traits<CPU>::paint_stacks, page-grained with lazy stacks)
+    unsigned int stack_used() const;
+    unsigned int stack_peak() const;
+
+    // Whether it has ever used the FPU (and thus got an FPU_Context, see Traits<CPU>::fpu)
+    bool fpu_used() const { return _fpu != 0; }
+
     static Thread * volatile self() { return running(); }
     static void yield();
     static void exit(int status = 0);
 
+    static void memory_report();
+
 protected:
     void constructor(const Log_Addr & entry, unsigned int stack_size);
 
+    char * alloc_stack(unsigned int size, bool scratchpad = false);
+    Context * adopt_stack(Context * context, char * frame);
+    void free_stack();
+
     static Thread * volatile running() { return _scheduler.chosen(); }
 
     Queue::Element * link() { return &_link; }
@@ -111,12 +131,14 @@ protected:
     static void wakeup(Queue * q);
     static void wakeup_all(Queue * q);
 
-    static void reschedule();
+    static void reschedule(bool preempt = false);
     static void time_slicer(const IC::Interrupt_Id & interrupt);
 
     static void implicit_exit();
 
-    static void dispatch(Thread * prev, Thread * next, bool charge = true);
+    static void fpu_switch(const IC::Interrupt_Id & interrupt);
+
+    static void dispatch(Thread * prev, Thread * next, bool charge = true, bool preempt = false);
 
     static int idle();
 
@@ -125,7 +147,10 @@ private:
 
 protected:
     char * _stack;
+    unsigned int _stack_size;
+    Segment * _stack_segment; // holding the stack (see Task::alloc_stack()), or 0 for heap stacks
     Context * volatile _context;
+    CPU::FPU_Context * _fpu;
     volatile State _state;
     Queue * _waiting;
     Thread * volatile _joining;
@@ -136,28 +161,29 @@ protected:
 
     static volatile unsigned int _thread_count;
     static Scheduler_Timer * _timer;
+    static Thread * volatile _fpu_owner;
     static Scheduler<Thread> _scheduler;
 };
 
 
 template<typename ... Tn>
 inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
-: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL), _link_task(this)
+: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL), _link_task(this), _task(running()->_task)
 {
     lock();
-    _stack = new (SYSTEM) char[STACK_SIZE];
-    _context = CPU::init_stack(_stack, STACK_SIZE, &implicit_exit, entry, an ...);
+    char * frame = alloc_stack(STACK_SIZE);
+    _context = adopt_stack(CPU::init_stack(frame, STACK_SIZE, &implicit_exit, entry, an ...), frame);
     running()->_task->insert(this);
     constructor(entry, STACK_SIZE); // implicit unlock
 }
 
 template<typename ... Cn, typename ... Tn>
 inline Thread::Thread(const Configuration & conf, int (* entry)(Tn ...), Tn ... an)
-: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion), _link_task(this)
+: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion), _link_task(this), _task(running()->_task)
 {
     lock();
-    _stack = new (SYSTEM) char[conf.stack_size];
-    _context = CPU::init_stack(_stack, conf.stack_size, &implicit_exit, entry, an ...);
+    char * frame = alloc_stack(conf.stack_size, conf.scratchpad);
+    _context = adopt_stack(CPU::init_stack(frame, conf.stack_size, &implicit_exit, entry, an ...), frame);
     running()->_task->insert(this);
     constructor(entry, conf.stack_size); // implicit unlock
 }
@@ -169,8 +195,8 @@ inline Thread::Thread(Task * task, int (* entry)(Tn ...), Tn ... an)
 : _state(READY), _waiting(0), _joining(0), _link(this, NORMAL), _link_task(this), _task(task)
 {
     lock();
-    _stack = new (SYSTEM) char[STACK_SIZE];
-    _context = CPU::init_stack(_stack, STACK_SIZE, &implicit_exit, entry, an ...);
+    char * frame = alloc_stack(STACK_SIZE);
+    _context = adopt_stack(CPU::init_stack(frame, STACK_SIZE, &implicit_exit, entry, an ...), frame);
     _task->insert(this);
     constructor(entry, STACK_SIZE); // implicit unlock
 }
@@ -180,8 +206,8 @@ inline Thread::Thread(Task * task, const Configuration & conf, int (* entry)(Tn
 : _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion), _link_task(this), _task(task)
 {
     lock();
-    _stack = new (SYSTEM) char[conf.stack_size];
-    _context = CPU::init_stack(_stack, conf.stack_size, &implicit_exit, entry, an ...);
+    char * frame = alloc_stack(conf.stack_size, conf.scratchpad);
+    _context = adopt_stack(CPU::init_stack(frame, conf.stack_size, &implicit_exit, entry, an ...), frame);
     _task->insert(this);
     constructor(entry, conf.stack_size); // implicit unlock
 }
@@ -54,6 +54,28 @@ public:
         return true;
     }
 
+    bool test(unsigned int index) const {
+        return (index < BITS) && (_map[index / BPI] & (1 << (index & mask)));
+    }
+
+    // Index of the first set (or reset) bit at or after "from", BITS if there is none
+    unsigned int first_set(unsigned int from = 0) const { return first(from, 0); }
+    unsigned int first_reset(unsigned int from = 0) const { return first(from, ~0U); }
+
+private:
+    unsigned int first(unsigned int from, unsigned int invert) const {
+        for(unsigned int i = from / BPI; i < SIZE; i++) {
+            unsigned int word = _map[i] ^ invert;
+            if(i == from / BPI)
+                word &= ~((1U << (from & mask)) - 1);
+            if(word) {
+                unsigned int index = i * BPI + __builtin_ctz(word); // bsf
+                return (index < BITS) ? index : BITS;
+            }
+        }
+        return BITS;
+    }
+
 private:
      unsigned int _map[SIZE];
 };
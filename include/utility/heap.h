@@ -14,36 +14,66 @@ class Heap: private Grouping_List<char>
 {
 protected:
     static const bool typed = Traits<System>::multiheap;
+    static const bool profiled = Traits<Heaps>::profiled;
+
+public:
+    // Profiling (see Traits<Heaps>::profiled): allocations are counted by size class, class i
+    // holding requests of up to 2^(i + 4) bytes (the last one gets everything bigger)
+    static const unsigned int SIZE_CLASSES = 16;
+
+    struct Profile
+    {
+        Profile(): frees(0), failures(0), peak(0) {
+            for(unsigned int i = 0; i < SIZE_CLASSES; i++)
+                allocations[i] = 0;
+        }
+
+        unsigned int allocations[SIZE_CLASSES];
+        unsigned int frees;
+        unsigned int failures;
+        unsigned int peak;
+    };
 
 public:
     using Grouping_List<char>::empty;
     using Grouping_List<char>::size;
 
-    Heap() {
+    Heap(): _ranges(0), _capacity(0) {
         db<Init, Heaps>(TRC) << "Heap() => " << this << endl;
     }
 
-    Heap(void * addr, unsigned int bytes) {
+    Heap(void * addr, unsigned int bytes): _ranges(0), _capacity(0) {
         db<Init, Heaps>(TRC) << "Heap(addr=" << addr << ",bytes=" << bytes << ") => " << this << endl;
 
-        free(addr, bytes);
+        grow(addr, bytes);
+    }
+
+    // Adds the memory at [addr, addr + bytes) to the heap (e.g. the frames left over after initialization)
+    void grow(void * addr, unsigned int bytes) {
+        db<Init, Heaps>(TRC) << "Heap::grow(this=" << this << ",addr=" << addr << ",bytes=" << bytes << ")" << endl;
+
+        if(!addr || (bytes < sizeof(Range) + sizeof(Element)))
+            return;
+
+        Range * r = reinterpret_cast<Range *>(addr);
+        r->next = _ranges;
+        r->size = bytes - sizeof(Range);
+        _ranges = r;
+        _capacity += r->size;
+
+        free(r + 1, r->size);
     }
 
-    void * alloc(unsigned int bytes) {
+    // "site" is where the block is accounted to when profiling, which only the outermost allocators (e.g. malloc()
+    // and the operators new) can tell, since the functions between them and the heap might or might not be inlined
+    void * alloc(unsigned int bytes, void * site = 0) {
         db<Heaps>(TRC) << "Heap::alloc(this=" << this << ",bytes=" << bytes;
 
         if(!bytes)
             return 0;
 
-        if(!Traits<CPU>::unaligned_memory_access)
-            while((bytes % sizeof(void *)))
-                ++bytes;
-
-        if(typed)
-            bytes += sizeof(void *);  // add room for heap pointer
-        bytes += sizeof(int);         // add room for size
-        if(bytes < sizeof(Element))
-            bytes = sizeof(Element);
+        unsigned int requested = bytes;
+        bytes = block_size(bytes);
 
         Element * e = search_decrementing(bytes);
         if(!e) {
@@ -51,13 +81,51 @@ public:
             return 0;
         }
 
-        int * addr = reinterpret_cast<int *>(e->object() + e->size());
+        void * addr = header(e->object() + e->size(), bytes, requested, site);
 
-        if(typed)
-            *addr++ = reinterpret_cast<int>(this);
-        *addr++ = bytes;
+        db<Heaps>(TRC) << ") => " << addr << endl;
+
+        return addr;
+    }
 
-        db<Heaps>(TRC) << ") => " << reinterpret_cast<void *>(addr) << endl;
+    // Blocks whose first byte is aligned to a power of two (the fragments around them go back to the heap)
+    void * alloc(unsigned int bytes, unsigned int align, void * site = 0) {
+        if(align <= (Traits<CPU>::unaligned_memory_access ? 1 : sizeof(void *)))
+            return alloc(bytes, site);
+
+        db<Heaps>(TRC) << "Heap::alloc(this=" << this << ",bytes=" << bytes << ",align=" << align;
+
+        if(!bytes)
+            return 0;
+
+        unsigned int requested = bytes;
+        bytes = block_size(bytes);
+
+        // Enough room for the block at an aligned address preceded by nothing or by a free fragment
+        unsigned int room = bytes + align + sizeof(Element);
+        Element * e = search_decrementing(room);
+        if(!e) {
+            out_of_memory();
+            return 0;
+        }
+
+        char * raw = e->object() + e->size();
+        char * block = reinterpret_cast<char *>((reinterpret_cast<unsigned int>(raw) + HEADER_SIZE + align - 1) & ~(align - 1)) - HEADER_SIZE;
+        while((block != raw) && (static_cast<unsigned int>(block - raw) < sizeof(Element)))
+            block += align;
+
+        unsigned int head = block - raw;
+        unsigned int tail = room - head - bytes;
+        if(tail < sizeof(Element)) {
+            bytes += tail;
+            tail = 0;
+        }
+        free(raw, head);
+        free(block + bytes, tail);
+
+        void * addr = header(block, bytes, requested, site);
+
+        db<Heaps>(TRC) << ") => " << addr << endl;
 
         return addr;
     }
@@ -72,21 +140,195 @@ public:
         }
     }
 
-   static void typed_free(void * ptr) {
+    // Whether alloc(bytes) would succeed
+    bool fits(unsigned int bytes) {
+        return bytes && search_size(block_size(bytes));
+    }
+
+    // Grows or shrinks the block at ptr without moving it (growth takes the front of the free block right after it)
+    bool resize(void * ptr, unsigned int bytes) {
+        db<Heaps>(TRC) << "Heap::resize(this=" << this << ",ptr=" << ptr << ",bytes=" << bytes << ")" << endl;
+
+        int * size = reinterpret_cast<int *>(ptr) - 1;
+        char * addr = reinterpret_cast<char *>(ptr) - HEADER_SIZE;
+        unsigned int old = *size;
+
+        bytes = block_size(bytes);
+
+        if(bytes <= old) {
+            if(old - bytes >= sizeof(Element)) {
+                *size = bytes;
+                free(addr + bytes, old - bytes);
+            }
+            return true;
+        }
+
+        unsigned int claimed = search_claiming(addr + old, bytes - old);
+        if(!claimed)
+            return false;
+        *size = old + claimed;
+
+        if(profiled && (allocated() > _profile.peak))
+            _profile.peak = allocated();
+
+        return true;
+    }
+
+    // Bytes the caller can actually use in the block at ptr (at least what was asked for)
+    static unsigned int usable_size(void * ptr) {
+        return reinterpret_cast<int *>(ptr)[-1] - HEADER_SIZE;
+    }
+
+    // The Heap a block came from (typed heaps only)
+    static Heap * owner(void * ptr) {
+        return *reinterpret_cast<Heap **>(reinterpret_cast<char *>(ptr) - HEADER_SIZE);
+    }
+
+    // Occupation in bytes (allocated() includes the per-block headers)
+    unsigned int capacity() const { return _capacity; }
+    unsigned int available() const { return grouped_size(); }
+    unsigned int allocated() const { return _capacity - grouped_size(); }
+
+    // Free space in the Grouping_List: how many blocks, the largest one and the fragmentation, i.e.
+    // the share (in per mille) of the free bytes that the largest block cannot account for
+    unsigned int free_blocks() const { return Grouping_List<char>::size(); }
+    unsigned int largest_free() {
+        unsigned int largest = 0;
+        for(Element * e = head(); e; e = e->next())
+            if(e->size() > largest)
+                largest = e->size();
+        return largest;
+    }
+    unsigned int fragmentation() {
+        return available() ? 1000 - static_cast<unsigned long long>(largest_free()) * 1000 / available() : 0;
+    }
+
+    const Profile & profile() const { return _profile; }
+
+    // Writes the profile and every live block (with its allocation site) to "out" (anything with a put(char),
+    // such as an UART) in the format read by tools/eposheap: "EHP" and a version byte followed by LEB128
+    // numbers (heap, capacity, used, peak, free, free blocks, largest free block, frees, failures, the
+    // allocations of each size class and then site and size pairs up to a null site), closed by a
+    // 16-bit sum of all the bytes after the magic
+    template<typename Sink>
+    void dump(Sink & out) {
+        out.put('E'); out.put('H'); out.put('P'); out.put(1);
+
+        unsigned int sum = 0;
+        sum += put(out, reinterpret_cast<unsigned int>(this));
+        sum += put(out, _capacity);
+        sum += put(out, allocated());
+        sum += put(out, _profile.peak);
+        sum += put(out, available());
+        sum += put(out, free_blocks());
+        sum += put(out, largest_free());
+        sum += put(out, _profile.frees);
+        sum += put(out, _profile.failures);
+        sum += put(out, SIZE_CLASSES);
+        for(unsigned int i = 0; i < SIZE_CLASSES; i++)
+            sum += put(out, _profile.allocations[i]);
+
+        // Live and free blocks tile each range, so they can be walked from its beginning. A free block starts with its
+        // Element, whose object() is the block itself, while a live one starts with its header (heap, site or size)
+        for(Range * r = _ranges; r; r = r->next) {
+            char * end = reinterpret_cast<char *>(r + 1) + r->size;
+            for(char * block = reinterpret_cast<char *>(r + 1); block < end; ) {
+                Element * e = reinterpret_cast<Element *>(block);
+                if(e->object() == block) {
+                    block += e->size();
+                    continue;
+                }
+                int * addr = reinterpret_cast<int *>(block + HEADER_SIZE);
+                unsigned int bytes = addr[-1];
+                sum += put(out, (profiled && addr[-2]) ? addr[-2] : 1); // 1 stands for an unknown site
+                sum += put(out, bytes);
+                block += bytes;
+            }
+        }
+        sum += put(out, 0);
+
+        out.put(sum & 0xff);
+        out.put((sum >> 8) & 0xff);
+    }
+
+    static void typed_free(void * ptr) {
         int * addr = reinterpret_cast<int *>(ptr);
-        unsigned int bytes = *--addr;
-        Heap * heap = reinterpret_cast<Heap *>(*--addr);
-        heap->free(addr, bytes);
+        unsigned int bytes = addr[-1];
+        Heap * heap = owner(ptr);
+        if(profiled)
+            heap->_profile.frees++;
+        heap->free(reinterpret_cast<char *>(ptr) - HEADER_SIZE, bytes);
     }
 
     static void untyped_free(Heap * heap, void * ptr) {
         int * addr = reinterpret_cast<int *>(ptr);
-        unsigned int bytes = *--addr;
-        heap->free(addr, bytes);
+        unsigned int bytes = addr[-1];
+        if(profiled)
+            heap->_profile.frees++;
+        heap->free(reinterpret_cast<char *>(ptr) - HEADER_SIZE, bytes);
     }
 
 private:
+    // Each range of memory given to the heap starts with one of these, which also keeps the free blocks
+    // of adjacent ranges from merging into each other (so dump() can walk the ranges one by one)
+    struct Range
+    {
+        Range * next;
+        unsigned int size;
+    };
+
+    // Block header: heap pointer (typed heaps), allocation site (profiled heaps) and size
+    static const unsigned int HEADER_SIZE = (typed ? sizeof(void *) : 0) + (profiled ? sizeof(void *) : 0) + sizeof(int);
+
+    void * header(char * block, unsigned int bytes, unsigned int requested, void * site) {
+        int * addr = reinterpret_cast<int *>(block);
+
+        if(typed)
+            *addr++ = reinterpret_cast<int>(this);
+        if(profiled)
+            *addr++ = reinterpret_cast<int>(site);
+        *addr++ = bytes;
+
+        if(profiled) {
+            unsigned int c = (requested <= 16) ? 0 : 32 - __builtin_clz(requested - 1) - 4;
+            _profile.allocations[(c < SIZE_CLASSES) ? c : SIZE_CLASSES - 1]++;
+            if(allocated() > _profile.peak)
+                _profile.peak = allocated();
+        }
+
+        return addr;
+    }
+
+    template<typename Sink>
+    static unsigned int put(Sink & out, unsigned int n) {
+        unsigned int sum = 0;
+        do {
+            unsigned char byte = (n & 0x7f) | ((n > 0x7f) ? 0x80 : 0);
+            out.put(byte);
+            sum += byte;
+            n >>= 7;
+        } while(n);
+        return sum;
+    }
+
+    static unsigned int block_size(unsigned int bytes) {
+        if(!Traits<CPU>::unaligned_memory_access)
+            while((bytes % sizeof(void *)))
+                ++bytes;
+
+        bytes += HEADER_SIZE;
+        if(bytes < sizeof(Element))
+            bytes = sizeof(Element);
+
+        return bytes;
+    }
+
     void out_of_memory();
+
+private:
+    Range * _ranges;
+    unsigned int _capacity;
+    Profile _profile;
 };
 
 __END_UTIL
@@ -1143,15 +1143,37 @@ public:
         print_tail();
 
         Element * e = search_size(s);
-        if(e) {
-            e->shrink(s);
-            _grouped_size -= s;
-            if(!e->size())
-                remove(e);
-        }
+        if(e)
+            decrement(e, s);
 
         return e;
     }
+
+    // Takes the last s units of e
+    void decrement(Element * e, unsigned int s) {
+        e->shrink(s);
+        _grouped_size -= s;
+        if(!e->size())
+            remove(e);
+    }
+
+    // Takes s bytes off the front of the element at obj (all of it if the rest could not hold an Element)
+    unsigned int search_claiming(Object_Type * obj, unsigned int s) {
+        db<Lists>(TRC) << "Grouping_List::search_claiming(obj=" << reinterpret_cast<void *>(obj) << ",s=" << s << ")" << endl;
+
+        Element * e = search(obj);
+        if(!e || (e->size() < s))
+            return 0;
+
+        remove(e);
+        if(e->size() - s < sizeof(Element))
+            s = e->size();
+        else
+            insert_tail(new (obj + s) Element(obj + s, e->size() - s));
+        _grouped_size -= s;
+
+        return s;
+    }
     
 private:
     unsigned int _grouped_size;
@@ -12,12 +12,26 @@ extern "C"
     using namespace EPOS;
 
     // Standard C Library allocators
-    inline void * malloc(size_t bytes) {
+    // (the outermost ones are never inlined, so their return address is the allocation site, see Heap::alloc())
+    inline __attribute__((noinline)) void * malloc(size_t bytes) {
         __USING_SYS;
         if(Traits<System>::multiheap)
-            return Application::_heap->alloc(bytes);
+            return Application::_heap->alloc(bytes, __builtin_return_address(0));
         else
-            return System::_heap->alloc(bytes);
+            return System::_heap->alloc(bytes, __builtin_return_address(0));
+    }
+
+    // Aligned to a power of two
+    inline __attribute__((noinline)) void * memalign(size_t align, size_t bytes) {
+        __USING_SYS;
+        if(Traits<System>::multiheap)
+            return Application::_heap->alloc(bytes, align, __builtin_return_address(0));
+        else
+            return System::_heap->alloc(bytes, align, __builtin_return_address(0));
+    }
+
+    inline void * aligned_alloc(size_t align, size_t bytes) {
+        return memalign(align, bytes);
     }
 
     inline void * calloc(size_t n, unsigned int bytes) {
@@ -33,15 +47,50 @@ extern "C"
         else
             Heap::untyped_free(System::_heap, ptr);
     }
+
+    // Resizes in place whenever the block can grow into its free neighbor, copies otherwise
+    inline __attribute__((noinline)) void * realloc(void * ptr, size_t bytes) {
+        __USING_SYS;
+        if(!ptr)
+            return malloc(bytes);
+        if(!bytes) {
+            free(ptr);
+            return 0;
+        }
+
+        Heap * heap = Traits<System>::multiheap ? Heap::owner(ptr) : System::_heap;
+        if(heap->resize(ptr, bytes))
+            return ptr;
+
+        void * moved = heap->alloc(bytes, __builtin_return_address(0));
+        if(moved) {
+            memcpy(moved, ptr, Heap::usable_size(ptr));
+            free(ptr);
+        }
+        return moved;
+    }
+
+    inline size_t malloc_usable_size(void * ptr) {
+        __USING_SYS;
+        return ptr ? Heap::usable_size(ptr) : 0;
+    }
 }
 
 // C++ dynamic memory allocators and deallocators
-inline void * operator new(size_t bytes) {
-    return malloc(bytes);
+inline __attribute__((noinline)) void * operator new(size_t bytes) {
+    __USING_SYS;
+    if(Traits<System>::multiheap)
+        return Application::_heap->alloc(bytes, __builtin_return_address(0));
+    else
+        return System::_heap->alloc(bytes, __builtin_return_address(0));
 }
 
-inline void * operator new[](size_t bytes) {
-    return malloc(bytes);
+inline __attribute__((noinline)) void * operator new[](size_t bytes) {
+    __USING_SYS;
+    if(Traits<System>::multiheap)
+        return Application::_heap->alloc(bytes, __builtin_return_address(0));
+    else
+        return System::_heap->alloc(bytes, __builtin_return_address(0));
 }
 
 // Delete cannot be declared inline due to virtual destructors
@@ -0,0 +1,83 @@
+// EPOS Region (Arena) Allocator Utility Declarations
+
+#ifndef __region_h
+#define __region_h
+
+#include <utility/debug.h>
+#include <utility/malloc.h>
+
+__BEGIN_UTIL
+
+// Region
+// Bump-pointer allocation from chunks taken from the heap (with memalign()),
+// with no per-object free: everything goes away at once on reset() or on
+// destruction (no destructors are called). A Region has a single owner
+// (e.g. a Task or a request handler), so it takes no locks.
+class Region
+{
+private:
+    static const unsigned int CHUNK_SIZE = 16 * 1024;
+    static const unsigned int ALIGNMENT = 8;
+
+    // Lives at the beginning of each chunk (and keeps what follows it ALIGNMENT-aligned)
+    struct Chunk
+    {
+        Chunk * next;
+        unsigned int size;
+    };
+
+public:
+    Region(unsigned int chunk_size = CHUNK_SIZE);
+    ~Region();
+
+    void * alloc(unsigned int bytes) {
+        bytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        if(bytes > static_cast<unsigned int>(_limit - _top))
+            if(!grow(bytes))
+                return 0;
+
+        void * addr = _top;
+        _top += bytes;
+        _allocated += bytes;
+
+        return addr;
+    }
+
+    // Releases every object (the first chunk is kept for reuse)
+    void reset();
+
+    unsigned int allocated() const { return _allocated; }
+    unsigned int size() const;
+
+private:
+    bool grow(unsigned int bytes);
+    void release(Chunk * chunk);
+
+private:
+    unsigned int _chunk_size;
+    Chunk * _chunks;
+    char * _top;
+    char * _limit;
+    unsigned int _allocated;
+};
+
+__END_UTIL
+
+// new (region) T and new (&region) T allocate T in the Region (delete must not be called on them)
+inline void * operator new(size_t bytes, _UTIL::Region & region) {
+    return region.alloc(bytes);
+}
+
+inline void * operator new[](size_t bytes, _UTIL::Region & region) {
+    return region.alloc(bytes);
+}
+
+inline void * operator new(size_t bytes, _UTIL::Region * region) {
+    return region->alloc(bytes);
+}
+
+inline void * operator new[](size_t bytes, _UTIL::Region * region) {
+    return region->alloc(bytes);
+}
+
+#endif
@@ -1,6 +1,7 @@
 // EPOS Address_Space Abstraction Implementation
 
 #include <address_space.h>
+#include <machine.h>
 
 __BEGIN_SYS
 
@@ -42,7 +43,14 @@ void Address_Space::detach(const Segment & seg)
 {
     db<Address_Space>(TRC) << "Address_Space::detach(seg=" << &seg << ")" << endl;
 
-    Directory::detach(seg);
+    flush(seg, Directory::detach(seg));
+}
+
+void Address_Space::detach(const Segment & seg, Address_Space::Log_Addr addr)
+{
+    db<Address_Space>(TRC) << "Address_Space::detach(seg=" << &seg << ",addr=" << addr << ")" << endl;
+
+    flush(seg, Directory::detach(seg, addr));
 }
 
 Address_Space::Phy_Addr Address_Space::physical(Address_Space::Log_Addr address)
@@ -50,4 +58,42 @@ Address_Space::Phy_Addr Address_Space::physical(Address_Space::Log_Addr address)
     return Directory::physical(address);
 }
 
+// The whole range the segment's page tables covered, which is what other CPUs might still have cached
+void Address_Space::flush(const Segment & seg, Address_Space::Log_Addr addr)
+{
+    if(addr)
+        flush(addr, addr + seg.pts() * MMU::PT_ENTRIES * sizeof(MMU::Page));
+}
+
+void Address_Space::flush()
+{
+    db<Address_Space>(TRC) << "Address_Space::flush()" << endl;
+
+    if(Traits<System>::multicore && (Machine::n_cpus() > 1))
+        IC::call(~0U, &flush, 0);
+    else
+        MMU::flush_tlb();
+}
+
+void Address_Space::flush(Address_Space::Log_Addr from, Address_Space::Log_Addr to)
+{
+    db<Address_Space>(TRC) << "Address_Space::flush(from=" << from << ",to=" << to << ")" << endl;
+
+    Log_Addr range[2] = { from, to };
+    if(Traits<System>::multicore && (Machine::n_cpus() > 1))
+        IC::call(~0U, &flush, range); // waits for all CPUs, so "range" can live on the stack
+    else
+        flush(range);
+}
+
+// Runs on each CPU (a null range means the whole TLB)
+void Address_Space::flush(void * range)
+{
+    Log_Addr * r = reinterpret_cast<Log_Addr *>(range);
+    if(r)
+        MMU::flush_tlb(r[0], r[1]);
+    else
+        MMU::flush_tlb();
+}
+
 __END_SYS
@@ -0,0 +1,128 @@
+// EPOS Zero-copy Inter-Task Communication Channel Abstraction Implementation
+
+#include <channel.h>
+
+__BEGIN_SYS
+
+// Methods
+Channel::Channel(unsigned int buffers, unsigned int buffer_size):
+    _buffers(buffers), _buffer_size((buffer_size + 63) & ~63), _ring_size(ring_size(buffers)),
+    _segment(2 * _ring_size + _buffers * _buffer_size), _full(0), _empty(buffers)
+{
+    db<Channel>(TRC) << "Channel(buffers=" << buffers
+                     << ",buffer_size=" << buffer_size
+                     << ") => " << this << endl;
+
+    _as[SENDER] = _as[RECEIVER] = 0;
+    _base[SENDER] = _base[RECEIVER] = 0;
+
+    // Such a channel can't be attached (see attach())
+    if(!buffers) {
+        db<Channel>(ERR) << "Channel(buffers=0): a channel needs at least one buffer!" << endl;
+        return;
+    }
+
+    // The rings are initialized here, through a mapping of the channel's own in the address space of its creator,
+    // so they are ready before any end is attached (to whatever address space)
+    Address_Space as(MMU::current());
+    char * base = as.attach(_segment);
+    if(!base) {
+        db<Channel>(ERR) << "Channel(buffers=" << buffers << "): no room to initialize the rings!" << endl;
+        _buffers = 0;
+        return;
+    }
+    Ring * full = reinterpret_cast<Ring *>(base);
+    Ring * empty = reinterpret_cast<Ring *>(base + _ring_size);
+    full->head = full->tail = 0;
+    empty->head = empty->tail = 0;
+    for(unsigned int i = 0; i < _buffers; i++) {
+        Descriptor d = { 2 * _ring_size + i * _buffer_size, 0 };
+        empty->put(_buffers, d);
+    }
+    as.detach(_segment, base);
+}
+
+
+Channel::~Channel()
+{
+    db<Channel>(TRC) << "~Channel(this=" << this << ")" << endl;
+
+    if(_as[SENDER])
+        detach(SENDER);
+    if(_as[RECEIVER])
+        detach(RECEIVER);
+}
+
+
+Channel::Log_Addr Channel::attach(End end, Address_Space * as)
+{
+    if(!_buffers)
+        return Log_Addr(false);
+
+    Log_Addr addr = _segment.attach(as);
+
+    db<Channel>(TRC) << "Channel::attach(end=" << end << ",as=" << as << ") => " << addr << endl;
+
+    if(!addr)
+        return addr;
+
+    _as[end] = as;
+    _base[end] = addr;
+
+    return addr;
+}
+
+
+void Channel::detach(End end)
+{
+    db<Channel>(TRC) << "Channel::detach(end=" << end << ")" << endl;
+
+    _segment.detach(_as[end], _base[end]);
+    _as[end] = 0;
+    _base[end] = 0;
+}
+
+
+void * Channel::alloc()
+{
+    _empty.p();
+    void * b = buffer(SENDER, ring(SENDER, 1)->get(_buffers));
+
+    db<Channel>(TRC) << "Channel::alloc() => " << b << endl;
+
+    return b;
+}
+
+
+void Channel::send(void * b, unsigned int size)
+{
+    db<Channel>(TRC) << "Channel::send(buf=" << b << ",size=" << size << ")" << endl;
+
+    Descriptor d = { offset(SENDER, b), size };
+    ring(SENDER, 0)->put(_buffers, d);
+    _full.v();
+}
+
+
+void * Channel::receive(unsigned int * size)
+{
+    _full.p();
+    Descriptor d = ring(RECEIVER, 0)->get(_buffers);
+    *size = d.size;
+
+    db<Channel>(TRC) << "Channel::receive() => {buf=" << buffer(RECEIVER, d) << ",size=" << d.size << "}" << endl;
+
+    return buffer(RECEIVER, d);
+}
+
+
+void Channel::release(void * b)
+{
+    db<Channel>(TRC) << "Channel::release(buf=" << b << ")" << endl;
+
+    Descriptor d = { offset(RECEIVER, b), 0 };
+    ring(RECEIVER, 1)->put(_buffers, d);
+    _empty.v();
+}
+
+__END_SYS
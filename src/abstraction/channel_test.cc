@@ -0,0 +1,73 @@
+// EPOS Channel Test Program (zero-copy throughput between two threads, each end of the channel mapped
+// at an address of its own; Task(cs, ds) shares its creator's address space, so this is not inter-task)
+
+#include <utility/ostream.h>
+#include <chronometer.h>
+#include <thread.h>
+#include <task.h>
+#include <channel.h>
+
+using namespace EPOS;
+
+const unsigned int messages = 10000;
+const unsigned int buffers = 16;
+const unsigned int buffer_size = 4096;
+
+OStream cout;
+
+Channel * channel;
+
+int receiver()
+{
+    unsigned int sum = 0;
+    for(unsigned int i = 0; i < messages; i++) {
+        unsigned int size;
+        unsigned int * msg = reinterpret_cast<unsigned int *>(channel->receive(&size));
+        sum += msg[0] + size;
+        channel->release(msg);
+    }
+    return sum;
+}
+
+int main()
+{
+    cout << "Channel test" << endl;
+
+    Address_Space * as = Task::self()->address_space();
+
+    cout << "Creating a channel with " << buffers << " buffers of " << buffer_size << " bytes:";
+    channel = new Channel(buffers, buffer_size);
+    CPU::Log_Addr tx = channel->attach(Channel::SENDER, as);
+    CPU::Log_Addr rx = channel->attach(Channel::RECEIVER, as);
+    cout << " sender => " << tx << ", receiver => " << rx << endl;
+
+    Thread * t = new Thread(&receiver);
+
+    cout << "Sending " << messages << " messages:" << endl;
+    Chronometer chrono;
+    unsigned int sum = 0;
+    chrono.start();
+    for(unsigned int i = 0; i < messages; i++) {
+        unsigned int * msg = reinterpret_cast<unsigned int *>(channel->alloc());
+        msg[0] = i; // the payload is written in place, no copies
+        sum += i + buffer_size;
+        channel->send(msg, buffer_size);
+    }
+    int received = t->join();
+    chrono.stop();
+
+    Chronometer::Microsecond us = chrono.read();
+    cout << "  elapsed time = " << us << " us" << endl;
+    cout << "  throughput = " << (us ? (unsigned long long)messages * buffer_size / us : 0) << " MB/s, "
+         << (us ? (unsigned long long)messages * 1000000 / us : 0) << " messages/s" << endl;
+    cout << "  checksum " << ((unsigned int)received == sum ? "matches" : "does not match") << endl;
+
+    channel->detach(Channel::RECEIVER);
+    channel->detach(Channel::SENDER);
+    delete t;
+    delete channel;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
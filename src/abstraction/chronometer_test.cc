@@ -2,6 +2,7 @@
 
 #include <utility/ostream.h>
 #include <chronometer.h>
+#include <clock.h>
 #include <alarm.h>
 
 using namespace EPOS;
@@ -22,5 +23,17 @@ int main()
 
     cout << "\nElapsed time = " << timepiece.read() << " us" << endl;
 
+    // The cost of the time stamps themselves is discounted, so an empty measurement should read 0
+    timepiece.reset();
+    timepiece.start();
+    timepiece.stop();
+    cout << "Empty measurement = " << timepiece.read() << " us" << endl;
+
+    Clock clock;
+    Clock::Nanosecond t0 = clock.now();
+    Alarm::delay(100000);
+    Clock::Nanosecond t1 = clock.now();
+    cout << "Clock: 100 ms took " << (t1 - t0) / 1000 << " us (resolution = " << clock.resolution() << " ns)" << endl;
+
     return 0;
 }
@@ -0,0 +1,75 @@
+// EPOS Page Colouring Test Program (strides over a Segment with a full and with a single colour budget)
+
+#include <utility/ostream.h>
+#include <chronometer.h>
+#include <thread.h>
+#include <task.h>
+
+using namespace EPOS;
+
+const unsigned int SEGMENT_SIZE = 128 * 1024; // fits in the L2 only if spread over all colours
+const unsigned int STRIDE = 64; // a cache line
+const unsigned int ROUNDS = 100;
+
+OStream cout;
+
+int stride()
+{
+    Address_Space * as = Task::self()->address_space();
+    Segment * seg = new Segment(SEGMENT_SIZE);
+    volatile char * base = as->attach(*seg);
+
+    unsigned int colours[MMU::COLOURS];
+    for(unsigned int c = 0; c < MMU::COLOURS; c++)
+        colours[c] = 0;
+    for(unsigned int i = 0; i < SEGMENT_SIZE; i += sizeof(MMU::Page))
+        colours[MMU::colour(MMU::physical(const_cast<char *>(base + i)))]++;
+    cout << "  pages per colour:";
+    for(unsigned int c = 0; c < MMU::COLOURS; c++)
+        cout << " " << colours[c];
+    cout << endl;
+
+    Chronometer chrono;
+    unsigned int sum = 0;
+    chrono.start();
+    for(unsigned int r = 0; r < ROUNDS; r++)
+        for(unsigned int i = 0; i < SEGMENT_SIZE; i += STRIDE)
+            sum += base[i];
+    chrono.stop();
+
+    as->detach(*seg);
+    delete seg;
+
+    cout << "  " << ROUNDS << " strides over " << SEGMENT_SIZE << " bytes in " << chrono.read() << " us (sum=" << sum << ")" << endl;
+
+    return chrono.read();
+}
+
+int main()
+{
+    cout << "Page colouring test" << endl;
+
+    if(!MMU::colouring)
+        cout << "Colouring is disabled (Traits<IA32_MMU>::colouring), both runs take whatever frames are free" << endl;
+
+    cout << "Striding in this task (budget=" << reinterpret_cast<void *>(Task::self()->colours()) << "):" << endl;
+    int all = stride();
+
+    const Task * task0 = Task::self();
+    Segment * cs1 = new Segment(task0->code_segment()->size());
+    Segment * ds1 = new Segment(task0->data_segment()->size());
+    Task * task1 = new Task(*cs1, *ds1);
+    task1->colours(1);
+
+    cout << "Striding in a task restricted to colour 0:" << endl;
+    Thread * t = new Thread(task1, &stride);
+    int one = t->join();
+
+    cout << "Single colour / all colours = " << (all ? one * 100 / all : 0) << "%, colour misses=" << MMU::colour_misses() << endl;
+
+    delete task1;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
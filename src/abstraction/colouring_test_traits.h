@@ -0,0 +1,188 @@
+#ifndef __traits_h
+#define __traits_h
+
+#include <system/config.h>
+
+__BEGIN_SYS
+
+// Global Configuration
+template<typename T>
+struct Traits
+{
+    static const bool enabled = true;
+    static const bool debugged = true;
+    static const bool hysterically_debugged = false;
+};
+
+template<> struct Traits<Build>
+{
+    enum {LIBRARY, BUILTIN};
+    static const unsigned int MODE = BUILTIN;
+
+    enum {IA32};
+    static const unsigned int ARCHITECTURE = IA32;
+
+    enum {PC};
+    static const unsigned int MACHINE = PC;
+
+    enum {Legacy};
+    static const unsigned int MODEL = Legacy;
+
+    static const unsigned int CPUS = 1;
+    static const unsigned int NODES = 1; // > 1 => NETWORKING
+};
+
+
+// Utilities
+template<> struct Traits<Debug>
+{
+    static const bool error   = true;
+    static const bool warning = true;
+    static const bool info    = false;
+    static const bool trace   = false;
+};
+
+template<> struct Traits<Lists>: public Traits<void>
+{
+    static const bool debugged = hysterically_debugged;
+};
+
+template<> struct Traits<Spin>: public Traits<void>
+{
+    static const bool debugged = hysterically_debugged;
+};
+
+template<> struct Traits<Heaps>: public Traits<void>
+{
+    static const bool debugged = hysterically_debugged;
+
+    // Count allocations by size class, track the peak usage and tag blocks with their allocation site
+    // (Heap::dump() sends it all to tools/eposheap, which happens by itself when a heap runs out of memory)
+    static const bool profiled = false;
+};
+
+
+// System Parts (mostly to fine control debugging)
+template<> struct Traits<Boot>: public Traits<void>
+{
+};
+
+template<> struct Traits<Setup>: public Traits<void>
+{
+};
+
+template<> struct Traits<Init>: public Traits<void>
+{
+};
+
+
+// Mediators
+template<> struct Traits<Serial_Display>: public Traits<void>
+{
+    static const bool enabled = true;
+    static const int COLUMNS = 80;
+    static const int LINES = 24;
+    static const int TAB_SIZE = 8;
+};
+
+// The MMU is configured along with the system (rather than with the architecture), so applications can tune it
+template<> struct Traits<IA32_MMU>: public Traits<void>
+{
+    static const bool large_pages = true; // 4 MB pages (CR4.PSE) for contiguous memory and the physical memory window
+    static const unsigned int zeroed_frames = 32; // frames kept zeroed by the idle thread for calloc() (0 disables the pool)
+
+    // Page colouring: the pages of a Chunk take frames of the colours in the running Task's budget in turn
+    static const bool colouring = true;
+    static const unsigned int colours = 8; // L2 size / associativity / page size (a power of two, at most 32)
+};
+
+__END_SYS
+
+#include __ARCH_TRAITS_H
+#include __MACH_CONFIG_H
+#include __MACH_TRAITS_H
+
+__BEGIN_SYS
+
+
+// Abstractions
+template<> struct Traits<Application>: public Traits<void>
+{
+    static const unsigned int STACK_SIZE = Traits<Machine>::STACK_SIZE;
+    static const unsigned int HEAP_SIZE = Traits<Machine>::HEAP_SIZE;
+    static const unsigned int MAX_THREADS = Traits<Machine>::MAX_THREADS;
+};
+
+template<> struct Traits<System>: public Traits<void>
+{
+    static const unsigned int mode = Traits<Build>::MODE;
+    static const bool multithread = (Traits<Application>::MAX_THREADS > 1);
+    static const bool multitask = (mode != Traits<Build>::LIBRARY);
+    static const bool multicore = (Traits<Build>::CPUS > 1) && multithread;
+    static const bool multiheap = (mode != Traits<Build>::LIBRARY) || Traits<Scratchpad>::enabled;
+
+    enum {FOREVER = 0, SECOND = 1, MINUTE = 60, HOUR = 3600, DAY = 86400, WEEK = 604800, MONTH = 2592000, YEAR = 31536000};
+    static const unsigned long LIFE_SPAN = 1 * HOUR; // in seconds
+
+    static const bool reboot = true;
+
+    static const unsigned int STACK_SIZE = Traits<Machine>::STACK_SIZE;
+    static const unsigned int HEAP_SIZE = (Traits<Application>::MAX_THREADS + 1) * Traits<Application>::STACK_SIZE;
+};
+
+template<> struct Traits<Task>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multitask;
+};
+
+template<> struct Traits<Thread>: public Traits<void>
+{
+    static const bool smp = Traits<System>::multicore;
+
+    typedef Scheduling_Criteria::RR Criterion;
+    static const unsigned int QUANTUM = 10000; // us
+
+    // Stacks packed in a lazy Segment per task, grown on demand (up to STACK_SIZE) and with a guard page below each
+    // (single-core only: the stack pages are mapped by a page fault task, see PC_IC::exc_pf_task())
+    static const bool lazy_stacks = false;
+
+    // Print the stack and heap usage report when the last thread exits
+    static const bool report_memory = false;
+
+    static const bool trace_idle = hysterically_debugged;
+};
+
+template<> struct Traits<Scheduler<Thread> >: public Traits<void>
+{
+    static const bool debugged = Traits<Thread>::trace_idle || hysterically_debugged;
+};
+
+
+template<> struct Traits<Address_Space>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multiheap;
+};
+
+template<> struct Traits<Segment>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multiheap;
+};
+
+template<> struct Traits<Channel>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multiheap;
+};
+
+template<> struct Traits<Alarm>: public Traits<void>
+{
+    static const bool visible = hysterically_debugged;
+};
+
+template<> struct Traits<Synchronizer>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multithread;
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,127 @@
+// EPOS FPU Context Test Program (floating-point threads preempted by the time slicer)
+
+#include <utility/ostream.h>
+#include <thread.h>
+
+using namespace EPOS;
+
+const unsigned int ITERATIONS = 10000000;
+const unsigned int THREADS = 3;
+
+// Each thread runs under rounding modes of its own, both in the x87 control word and in the MXCSR
+struct Mode
+{
+    unsigned short fcw;
+    unsigned int mxcsr;
+};
+
+const Mode modes[THREADS] = {
+    {0x037f, 0x1f80}, // to nearest (the defaults)
+    {0x0f7f, 0x7f80}, // toward zero
+    {0x077f, 0x3f80}  // down
+};
+
+const unsigned int MXCSR_FLAGS = 0x3f; // exception flags, raised by the computations themselves
+
+volatile unsigned int last;
+volatile unsigned int switches;
+
+OStream cout;
+
+void set(const Mode & m)
+{
+    ASM("fldcw %0; ldmxcsr %1" : : "m"(m.fcw), "m"(m.mxcsr));
+}
+
+bool same(const Mode & m)
+{
+    unsigned short fcw;
+    unsigned int mxcsr;
+    ASM("fnstcw %0; stmxcsr %1" : "=m"(fcw), "=m"(mxcsr));
+    return (fcw == m.fcw) && ((mxcsr & ~MXCSR_FLAGS) == m.mxcsr);
+}
+
+// A long computation that never yields, with partial results held in x87 registers and in XMM7 (which the compiler
+// doesn't use), so they are live whenever the time slicer preempts it. Each rounding mode gives a different result
+bool series(unsigned int n, const Mode & m, double * x87, double * sse)
+{
+    bool ok = true;
+    double zero = 0;
+    double sum = 0;
+    double x = 1.0 + n / 8.0;
+
+    ASM("movsd %0, %%xmm7" : : "m"(zero));
+    for(unsigned int i = 1; i <= ITERATIONS; i++) {
+        double term = x / i;
+        sum += term;
+        x *= 1.0000001;
+        ASM("addsd %0, %%xmm7" : : "m"(term));
+
+        if(!(i & 0xfff)) {
+            ok = ok && same(m);
+            if(last != n) {
+                last = n;
+                switches++;
+            }
+        }
+    }
+    ASM("movsd %%xmm7, %0" : "=m"(*sse));
+    *x87 = sum;
+
+    return ok;
+}
+
+double x87_expected[THREADS];
+double sse_expected[THREADS];
+
+int fp(unsigned int n)
+{
+    set(modes[n]);
+
+    double x87, sse;
+    bool ok = series(n, modes[n], &x87, &sse);
+
+    return ok && (x87 == x87_expected[n]) && (sse == sse_expected[n]);
+}
+
+int integer()
+{
+    // Never touches the FPU, so it should never get an FPU context
+    unsigned int sum = 0;
+    for(unsigned int i = 1; i <= ITERATIONS; i++)
+        sum += i;
+    return sum == ITERATIONS * (ITERATIONS + 1) / 2;
+}
+
+int main()
+{
+    cout << "FPU context test" << endl;
+
+    cout << "Computing the expected results:";
+    for(unsigned int n = 0; n < THREADS; n++) {
+        set(modes[n]);
+        series(n, modes[n], &x87_expected[n], &sse_expected[n]);
+    }
+    set(modes[0]);
+    cout << " done!" << endl;
+
+    Thread * t[THREADS];
+    for(unsigned int n = 0; n < THREADS; n++)
+        t[n] = new Thread(&fp, n);
+    Thread * c = new Thread(&integer);
+
+    for(unsigned int n = 0; n < THREADS; n++)
+        cout << "  FP thread " << n << " " << (t[n]->join() ? "passed" : "failed") << endl;
+    int ok = c->join();
+    cout << "  Integer thread " << (ok ? "passed" : "failed") << ", "
+         << (c->fpu_used() ? "but got" : "and got no") << " FPU context" << endl;
+    cout << "  The FP threads were interleaved " << switches << " times" << (switches ? "" : " (not preempted!)") << endl;
+
+    for(unsigned int n = 0; n < THREADS; n++)
+        delete t[n];
+    delete c;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+// EPOS Threaded Interrupt Handler Abstraction Implementation
+
+#include <interrupt_thread.h>
+
+__BEGIN_SYS
+
+// Class attributes
+Interrupt_Thread * Interrupt_Thread::_threads[IC::INTS];
+
+// Methods
+Interrupt_Thread::Interrupt_Thread(const Interrupt_Id & i, const Interrupt_Handler & h, const Criterion & priority):
+    _id(i), _handler(h), _previous(IC::int_vector(i)), _pending(0), _finishing(false), _count(0)
+{
+    db<Thread>(TRC) << "Interrupt_Thread(int=" << i << ",h=" << reinterpret_cast<void *>(h)
+                    << ",priority=" << priority << ") => " << this << endl;
+
+    _thread = new (SYSTEM) Thread(Thread::Configuration(Thread::READY, priority), &run, this);
+
+    CPU::int_disable();
+    _threads[i] = this;
+    IC::int_vector(i, isr);
+    CPU::int_enable();
+}
+
+
+Interrupt_Thread::~Interrupt_Thread()
+{
+    db<Thread>(TRC) << "~Interrupt_Thread(this=" << this << ",int=" << _id << ")" << endl;
+
+    CPU::int_disable();
+    IC::int_vector(_id, _previous);
+    _threads[_id] = 0;
+    CPU::int_enable();
+
+    _finishing = true;
+    _pending.v();
+    _thread->join();
+    delete _thread;
+
+    // isr() might have masked the line for an interrupt the thread never got to handle
+    if(maskable(_id))
+        IC::enable(_id);
+}
+
+
+void Interrupt_Thread::isr(const Interrupt_Id & i)
+{
+    // The Interrupt_Thread might have just been deleted (e.g. another CPU fetched the vector before it was
+    // restored), in which case the line is left alone for the previous handler to take the next interrupt
+    Interrupt_Thread * it = _threads[i];
+    if(!it) {
+        db<Thread>(WRN) << "Interrupt_Thread::isr(int=" << i << "): no thread for this interrupt!" << endl;
+        return;
+    }
+
+    // The IC has already acknowledged the interrupt, so the line is masked until the thread has handled it
+    if(maskable(i))
+        IC::disable(i);
+
+    it->_pending.v();
+}
+
+
+int Interrupt_Thread::run(Interrupt_Thread * it)
+{
+    while(true) {
+        it->_pending.p();
+        if(it->_finishing)
+            break;
+
+        it->_handler(it->_id);
+        it->_count++;
+
+        if(maskable(it->_id))
+            IC::enable(it->_id);
+    }
+
+    return 0;
+}
+
+__END_SYS
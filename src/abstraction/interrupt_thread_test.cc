@@ -0,0 +1,56 @@
+// EPOS Threaded Interrupt Handler Test Program
+
+#include <utility/ostream.h>
+#include <interrupt_thread.h>
+#include <chronometer.h>
+#include <alarm.h>
+
+using namespace EPOS;
+
+const unsigned int interval = 500000; // us
+
+volatile unsigned int ticks = 0;
+
+OStream cout;
+
+// Runs in the Interrupt_Thread, not in the ISR
+void tick(const IC::Interrupt_Id & i)
+{
+    ticks++;
+}
+
+int main()
+{
+    cout << "Interrupt_Thread test" << endl;
+
+    IC::Interrupt_Handler previous = IC::int_vector(IC::INT_TIMER);
+
+    cout << "Threading the timer interrupt:";
+    Interrupt_Thread * it = new Interrupt_Thread(IC::INT_TIMER, &tick);
+    cout << " done!" << endl;
+
+    // The timer is ours now, so Alarm::delay() would never return: the Chronometer counts time stamps instead
+    Chronometer chrono;
+    chrono.start();
+    while(chrono.read() < interval);
+    chrono.stop();
+
+    unsigned int count = it->count();
+    cout << "After " << chrono.read() << " us, " << count << " interrupts were handled by the thread ("
+         << ticks << " ticks)" << endl;
+    cout << "  count " << (count > 0 ? "advanced" : "did not advance") << endl;
+
+    cout << "Deleting the Interrupt_Thread:";
+    delete it;
+    cout << " done!" << endl;
+    cout << "  the previous handler " << (IC::int_vector(IC::INT_TIMER) == previous ? "was" : "was not")
+         << " restored" << endl;
+
+    // With the timer handler back in place, alarms work again
+    Alarm::delay(interval);
+    cout << "  ticks after deletion = " << ticks - count << " (should be 0)" << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 // EPOS Memory Segment Abstraction Implementation
 
 #include <segment.h>
+#include <address_space.h>
 
 __BEGIN_SYS
 
@@ -26,18 +27,57 @@ Segment::Segment(Phy_Addr phy_addr, unsigned int bytes, Flags flags): Chunk(phy_
 }
 
 
+Segment::Segment(const Segment & segment, bool cow): Chunk(segment, cow)
+{
+    db<Segment>(TRC) << "Segment(segment=" << &segment
+                     << ",cow=" << cow
+                     << ") [Chunk::_pt=" << Chunk::pt() << "] => "
+                     << this << endl;
+
+    // Other CPUs might still hold writable translations for the pages now shared copy-on-write
+    if(cow)
+        Address_Space::flush();
+}
+
+
 Segment::~Segment()
 {
     db<Segment>(TRC) << "~Segment() [Chunk::_pt=" << Chunk::pt() << "]" << endl;
 }
 
 
+Segment * Segment::clone_cow() const
+{
+    db<Segment>(TRC) << "Segment::clone_cow()" << endl;
+
+    Segment * seg = new (SYSTEM) Segment(*this, true);
+    if(!seg->pt()) {
+        delete seg;
+        return 0;
+    }
+
+    return seg;
+}
+
+
 unsigned int Segment::size() const
 {
     return Chunk::size();
 }
 
 
+unsigned int Segment::resident() const
+{
+    return Chunk::resident();
+}
+
+
+unsigned int Segment::resident(unsigned int offset, unsigned int bytes) const
+{
+    return Chunk::resident(offset, bytes);
+}
+
+
 Segment::Phy_Addr Segment::phy_address() const
 {
     return Chunk::phy_address();
@@ -48,7 +88,33 @@ int Segment::resize(int amount)
 {
     db<Segment>(TRC) << "Segment::resize(amount=" << amount << ")" << endl;
 
-    return Chunk::resize(amount);
+    MMU::Page_Table * pt = Chunk::pt();
+    int bytes = Chunk::resize(amount);
+
+    // Other CPUs might still walk the old page tables through their paging-structure caches
+    if(Chunk::pt() != pt)
+        Address_Space::flush();
+
+    return bytes;
+}
+
+
+void Segment::guard(unsigned int offset)
+{
+    db<Segment>(TRC) << "Segment::guard(offset=" << offset << ")" << endl;
+
+    Chunk::guard(offset);
+}
+
+
+void Segment::discard(unsigned int offset, unsigned int bytes)
+{
+    db<Segment>(TRC) << "Segment::discard(offset=" << offset << ",bytes=" << bytes << ")" << endl;
+
+    Chunk::discard(offset, bytes);
+
+    // The frames just given back might still be cached in the TLBs
+    Address_Space::flush();
 }
 
 __END_SYS
@@ -8,6 +8,7 @@ using namespace EPOS;
 
 const unsigned ES1_SIZE = 10000;
 const unsigned ES2_SIZE = 100000;
+const unsigned ES3_SIZE = 1000000;
 
 int main()
 {
@@ -36,14 +37,36 @@ int main()
     memset(extra2, 0, ES2_SIZE);
     cout << "  done!" << endl;
 
+    cout << "Creating a lazy segment:" << endl;
+    Segment * es3 = new Segment(ES3_SIZE, Segment::Flags(Segment::Flags::APP | Segment::Flags::LAZY));
+    char * extra3 = self.attach(*es3);
+    cout << "  extra segment 3 => " << ES3_SIZE << " bytes at " << reinterpret_cast<void *>(extra3)
+         << ", resident=" << es3->resident() << endl;
+
+    cout << "Touching one byte every 64 KB:" << endl;
+    for(unsigned int i = 0; i < ES3_SIZE; i += 64 * 1024)
+        extra3[i] = 'x';
+    cout << "  size=" << es3->size() << ", resident=" << es3->resident() << endl;
+
+    cout << "Cloning segment 2 (copy-on-write):" << endl;
+    Segment * es4 = es2->clone_cow();
+    char * extra4 = self.attach(*es4);
+    extra4[0] = 'y';
+    cout << "  clone => " << reinterpret_cast<void *>(extra4) << ", original[0]=" << int(reinterpret_cast<char *>(extra2)[0])
+         << ", clone[0]=" << extra4[0] << endl;
+    self.detach(*es4);
+    delete es4;
+
     cout << "Detaching segments:";
     self.detach(*es1);
     self.detach(*es2);
+    self.detach(*es3);
     cout << "  done!" << endl;
 
     cout << "Deleting segments:";
     delete es1;
     delete es2;
+    delete es3;
     cout << "  done!" << endl;
 
     return 0;
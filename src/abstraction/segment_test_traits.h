@@ -55,6 +55,10 @@ template<> struct Traits<Spin>: public Traits<void>
 template<> struct Traits<Heaps>: public Traits<void>
 {
     static const bool debugged = hysterically_debugged;
+
+    // Count allocations by size class, track the peak usage and tag blocks with their allocation site
+    // (Heap::dump() sends it all to tools/eposheap, which happens by itself when a heap runs out of memory)
+    static const bool profiled = false;
 };
 
 
@@ -81,6 +85,17 @@ template<> struct Traits<Serial_Display>: public Traits<void>
     static const int TAB_SIZE = 8;
 };
 
+// The MMU is configured along with the system (rather than with the architecture), so applications can tune it
+template<> struct Traits<IA32_MMU>: public Traits<void>
+{
+    static const bool large_pages = true; // 4 MB pages (CR4.PSE) for contiguous memory and the physical memory window
+    static const unsigned int zeroed_frames = 32; // frames kept zeroed by the idle thread for calloc() (0 disables the pool)
+
+    // Page colouring: the pages of a Chunk take frames of the colours in the running Task's budget in turn
+    static const bool colouring = false;
+    static const unsigned int colours = 8; // L2 size / associativity / page size (a power of two, at most 32)
+};
+
 __END_SYS
 
 #include __ARCH_TRAITS_H
@@ -122,6 +137,13 @@ template<> struct Traits<Thread>: public Traits<void>
     typedef Scheduling_Criteria::RR Criterion;
     static const unsigned int QUANTUM = 10000; // us
 
+    // Stacks packed in a lazy Segment per task, grown on demand (up to STACK_SIZE) and with a guard page below each
+    // (single-core only: the stack pages are mapped by a page fault task, see PC_IC::exc_pf_task())
+    static const bool lazy_stacks = false;
+
+    // Print the stack and heap usage report when the last thread exits
+    static const bool report_memory = false;
+
     static const bool trace_idle = hysterically_debugged;
 };
 
@@ -141,6 +163,11 @@ template<> struct Traits<Segment>: public Traits<void>
     static const bool enabled = Traits<System>::multiheap;
 };
 
+template<> struct Traits<Channel>: public Traits<void>
+{
+    static const bool enabled = Traits<System>::multiheap;
+};
+
 template<> struct Traits<Alarm>: public Traits<void>
 {
     static const bool visible = hysterically_debugged;
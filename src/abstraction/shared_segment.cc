@@ -0,0 +1,46 @@
+// EPOS Shared Memory Segment Abstraction Implementation
+
+#include <shared_segment.h>
+
+__BEGIN_SYS
+
+// Methods
+Shared_Segment::Shared_Segment(unsigned int bytes, Flags flags): Segment(bytes, flags), _attachments(0)
+{
+    db<Segment>(TRC) << "Shared_Segment(bytes=" << bytes
+                     << ",flags=" << flags
+                     << ") => " << this << endl;
+}
+
+
+Shared_Segment::~Shared_Segment()
+{
+    db<Segment>(TRC) << "~Shared_Segment(this=" << this << ")" << endl;
+
+    if(_attachments)
+        db<Segment>(WRN) << "~Shared_Segment(this=" << this << "): still attached to "
+                         << _attachments << " address spaces!" << endl;
+}
+
+
+Shared_Segment::Log_Addr Shared_Segment::attach(Address_Space * as)
+{
+    Log_Addr addr = as->attach(*this);
+    if(addr)
+        CPU::finc(_attachments);
+
+    db<Segment>(TRC) << "Shared_Segment::attach(as=" << as << ") => " << addr << endl;
+
+    return addr;
+}
+
+
+void Shared_Segment::detach(Address_Space * as, Log_Addr addr)
+{
+    db<Segment>(TRC) << "Shared_Segment::detach(as=" << as << ",addr=" << addr << ")" << endl;
+
+    as->detach(*this, addr);
+    CPU::fdec(_attachments);
+}
+
+__END_SYS
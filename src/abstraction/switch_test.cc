@@ -0,0 +1,52 @@
+// EPOS Context Switch Test Program (two threads yielding to each other)
+
+#include <utility/ostream.h>
+#include <tsc.h>
+#include <thread.h>
+
+using namespace EPOS;
+
+const unsigned int ROUNDS = 10000;
+
+OStream cout;
+
+TSC::Time_Stamp start;
+TSC::Time_Stamp stop;
+
+int ping()
+{
+    start = TSC::time_stamp();
+    for(unsigned int i = 0; i < ROUNDS; i++)
+        Thread::yield();
+    stop = TSC::time_stamp();
+    return 0;
+}
+
+int pong()
+{
+    for(unsigned int i = 0; i < ROUNDS; i++)
+        Thread::yield();
+    return 0;
+}
+
+int main()
+{
+    cout << "Context switch test" << endl;
+
+    // Main waits in join(), so ping and pong are the only threads ready and each yield() is a switch
+    Thread * a = new Thread(&ping);
+    Thread * b = new Thread(&pong);
+    a->join();
+    b->join();
+
+    TSC::Time_Stamp cycles = stop - start;
+    cout << "  " << 2 * ROUNDS << " switches in " << cycles << " cycles" << endl;
+    cout << "  " << cycles / (2 * ROUNDS) << " cycles per switch (yield included)" << endl;
+
+    delete a;
+    delete b;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
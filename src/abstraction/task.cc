@@ -7,7 +7,7 @@ Task * Task::_master;
 Simple_List<Thread> Task::_threads;
 
 
-Task::Task() { }
+Task::Task(): _colours(MMU::ALL_COLOURS), _stacks(0), _stacks_base(0), _stacks_used(0) { }
 
 Task::Task(const Segment & cs, const Segment & ds)
 {
@@ -16,24 +16,81 @@ Task::Task(const Segment & cs, const Segment & ds)
 	_data_segment = &ds;
 	_code = CPU::Phy_Addr(Memory_Map<Machine>::APP_CODE);
 	_data = CPU::Phy_Addr(Memory_Map<Machine>::APP_DATA);
+	_colours = MMU::ALL_COLOURS;
+	_stacks = 0;
+	_stacks_base = 0;
+	_stacks_used = 0;
 }
 
 Task::~Task()
 {
-	delete _address_space;
-	delete _code_segment;
-	delete _data_segment;
-
+	// Threads give their stacks back to _stacks, which is in turn attached to _address_space
 	while(!_threads.empty()){
 		Thread * t = _threads.remove()->object();
 		delete t;
 	}
+
+	if(_stacks) {
+		_address_space->detach(*_stacks, _stacks_base);
+		delete _stacks;
+	}
+
+	delete _address_space;
+	delete _code_segment;
+	delete _data_segment;
 }
 
 const Task * Task::self(){
 		return Thread::self()->_task;
 }
 
+void Task::colours(unsigned int budget)
+{
+	_colours = budget & MMU::ALL_COLOURS;
+	if(!_colours)
+		_colours = MMU::ALL_COLOURS;
+	if(this == self())
+		MMU::budget(_colours);
+}
+
+// Returns the base of a free stack slot (in this task's address space) or 0 if there is none
+char * Task::alloc_stack()
+{
+	if(!_stacks) {
+		Segment * seg = new (SYSTEM) Segment(STACK_SLOTS * STACK_SLOT, Segment::Flags(Segment::Flags::APP | Segment::Flags::LAZY));
+		char * base = _address_space->attach(*seg);
+		if(!base) {
+			delete seg;
+			return 0;
+		}
+		for(unsigned int i = 0; i < STACK_SLOTS; i++)
+			seg->guard(i * STACK_SLOT);
+		_stacks = seg;
+		_stacks_base = base;
+	}
+
+	for(unsigned int i = 0; i < STACK_SLOTS; i++)
+		if(!(_stacks_used & (1U << i))) {
+			_stacks_used |= 1U << i;
+			return _stacks_base + i * STACK_SLOT + sizeof(MMU::Page);
+		}
+
+	return 0;
+}
+
+// The slot keeps its pages reserved, but its frames are given back
+void Task::free_stack(char * stack)
+{
+	unsigned int offset = stack - _stacks_base;
+	_stacks->discard(offset, STACK_SLOT - sizeof(MMU::Page));
+	_stacks_used &= ~(1U << (offset / STACK_SLOT));
+}
+
+unsigned int Task::stack_resident(char * stack) const
+{
+	return _stacks->resident(stack - _stacks_base, STACK_SLOT - sizeof(MMU::Page));
+}
+
 void Task::insert(Thread * t){
 	_threads.insert(&t->_link_task);
 	t->_task = this;
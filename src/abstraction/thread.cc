@@ -3,6 +3,8 @@
 #include <machine.h>
 #include <thread.h>
 #include <alarm.h>
+#include <application.h>
+#include <uart.h>
 
 // This_Thread class attributes
 __BEGIN_UTIL
@@ -14,6 +16,7 @@ __BEGIN_SYS
 // Class attributes
 volatile unsigned int Thread::_thread_count;
 Scheduler_Timer * Thread::_timer;
+Thread * volatile Thread::_fpu_owner;
 Scheduler<Thread> Thread::_scheduler;
 
 // Methods
@@ -27,6 +30,7 @@ void Thread::constructor(const Log_Addr & entry, unsigned int stack_size)
                     << "},context={b=" << _context
                     << "," << *_context << "}) => " << this << endl;
 
+    _fpu = 0;
     _thread_count++;
 
     _scheduler.insert(this);
@@ -85,7 +89,95 @@ Thread::~Thread()
     // É isso mesmo?
     _task->remove(this);
 
-    delete _stack;
+    if(_fpu_owner == this)
+        _fpu_owner = 0;
+    if(_fpu)
+        delete _fpu;
+
+    free_stack();
+}
+
+
+// Sets _stack and returns where the initial frame shall be written through (see adopt_stack())
+char * Thread::alloc_stack(unsigned int size, bool scratchpad)
+{
+    _stack_size = size;
+    _stack_segment = 0;
+
+    if(scratchpad)
+        return _stack = new (SCRATCHPAD) char[size];
+
+    if(lazy_stacks && _task && (size <= STACK_SIZE)) {
+        // Frames are only mapped as the stack grows, the page right below it is a guard
+        _stack = _task->alloc_stack();
+        if(_stack) {
+            _stack_segment = _task->_stacks;
+
+            // A stack in another address space gets a temporary mapping in the current one for init_stack()
+            if(_task->address_space()->pd() == CPU::Phy_Addr(MMU::current()))
+                return _stack;
+            char * alias = running()->_task->address_space()->attach(*_stack_segment);
+            if(alias)
+                return alias + (_stack - _task->_stacks_base);
+
+            db<Thread>(WRN) << "Thread::alloc_stack(size=" << size << "): no room to initialize the stack, using the heap!" << endl;
+            _task->free_stack(_stack);
+            _stack_segment = 0;
+        } else
+            db<Thread>(WRN) << "Thread::alloc_stack(size=" << size << "): no free stack slot, using the heap!" << endl;
+    }
+
+    return _stack = new (SYSTEM) char[size];
+}
+
+
+// Moves the context built by CPU::init_stack() at "frame" to _stack (the frame holds no pointers into the stack)
+Thread::Context * Thread::adopt_stack(Context * context, char * frame)
+{
+    if(frame == _stack)
+        return context;
+
+    char * alias = frame - (_stack - _task->_stacks_base);
+    running()->_task->address_space()->detach(*_stack_segment, alias);
+
+    return reinterpret_cast<Context *>(reinterpret_cast<char *>(context) - frame + _stack);
+}
+
+
+void Thread::free_stack()
+{
+    if(_stack_segment) {
+        lock();
+        _task->free_stack(_stack);
+        unlock();
+    } else
+        delete _stack;
+}
+
+
+unsigned int Thread::stack_used() const
+{
+    char * sp = (this == running()) ? reinterpret_cast<char *>(CPU::sp()) : reinterpret_cast<char *>(_context);
+
+    return _stack + _stack_size - sp;
+}
+
+
+unsigned int Thread::stack_peak() const
+{
+    if(CPU::paint_stacks) {
+        // The lowest word that no longer holds the paint (above the one exit() stores the status in)
+        CPU::Reg32 * w = reinterpret_cast<CPU::Reg32 *>(_stack) + 1;
+        CPU::Reg32 * top = reinterpret_cast<CPU::Reg32 *>(_stack + _stack_size);
+        while((w < top) && (*w == CPU::STACK_PAINT))
+            w++;
+        return (top - w) * sizeof(CPU::Reg32);
+    }
+
+    if(_stack_segment)
+        return _task->stack_resident(_stack);
+
+    return stack_used();
 }
 
 
@@ -284,7 +376,7 @@ void Thread::wakeup_all(Queue * q)
 }
 
 
-void Thread::reschedule()
+void Thread::reschedule(bool preempt)
 {
     db<Scheduler<Thread> >(TRC) << "Thread::reschedule()" << endl;
 
@@ -294,7 +386,7 @@ void Thread::reschedule()
     Thread * prev = running();
     Thread * next = _scheduler.choose();
 
-    dispatch(prev, next);
+    dispatch(prev, next, true, preempt);
 }
 
 
@@ -302,7 +394,7 @@ void Thread::time_slicer(const IC::Interrupt_Id & i)
 {
     lock();
 
-    reschedule();
+    reschedule(true);
 }
 
 
@@ -312,7 +404,32 @@ void Thread::implicit_exit()
 }
 
 
-void Thread::dispatch(Thread * prev, Thread * next, bool charge)
+void Thread::fpu_switch(const IC::Interrupt_Id & i)
+{
+    // The running thread issued its first FPU/SSE instruction since dispatch() set CR0.TS
+    CPU::fpu_enable();
+
+    Thread * r = running();
+    if(_fpu_owner == r)
+        return;
+
+    db<Thread>(TRC) << "Thread::fpu_switch(owner=" << _fpu_owner << ",running=" << r << ")" << endl;
+
+    if(_fpu_owner)
+        _fpu_owner->_fpu->save();
+
+    if(r->_fpu)
+        r->_fpu->load();
+    else {
+        r->_fpu = new (SYSTEM, 16) CPU::FPU_Context;
+        CPU::fpu_init();
+    }
+
+    _fpu_owner = r;
+}
+
+
+void Thread::dispatch(Thread * prev, Thread * next, bool charge, bool preempt)
 {
     if(charge) {
         if(Criterion::timed)
@@ -328,12 +445,42 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
           next->_task->activate();
         }
 
+        // The FPU still holds _fpu_owner's state, so anyone else must trap on their first use of it
+        if(CPU::fpu) {
+            if(next == _fpu_owner)
+                CPU::fpu_enable();
+            else
+                CPU::fpu_disable();
+        }
+
         db<Thread>(TRC) << "Thread::dispatch(prev=" << prev << ",next=" << next << ")" << endl;
         db<Thread>(INF) << "prev={" << prev << ",ctx=" << *prev->_context << "}" << endl;
         db<Thread>(INF) << "next={" << next << ",ctx=" << *next->_context << "}" << endl;
 
 
-        CPU::switch_context(&prev->_context, next->_context);
+        // With nested interrupts, next must not run with the interrupts masked by the handlers prev is in,
+        // and prev gets them back when it resumes (new threads thus start with no masks)
+        IC::Nesting nesting = 0;
+        if(IC::nested) {
+            nesting = IC::nesting();
+            IC::nesting(0);
+        }
+
+        // Interrupt handlers that got us here are charged until now, not until prev resumes
+        if(IC::statistics)
+            IC::switching();
+
+        // Preempted threads might be anywhere, so their whole context must be saved
+        if(preempt)
+            CPU::switch_context(&prev->_context, next->_context);
+        else
+            CPU::switch_context_lean(&prev->_context, next->_context);
+
+        // We are now the thread that was dispatched (possibly long ago)
+        if(IC::nested)
+            IC::nesting(nesting);
+        if(IC::statistics)
+            IC::wakeup();
     }
 
     unlock();
@@ -349,6 +496,8 @@ int Thread::idle()
         if(_thread_count <= 1) { // Only idle is left
             CPU::int_disable();
             db<Thread>(WRN) << "The last thread has exited!" << endl;
+            if(Traits<Thread>::report_memory)
+                memory_report();
             if(reboot) {
                 db<Thread>(WRN) << "Rebooting the machine ..." << endl;
                 Machine::reboot();
@@ -357,7 +506,14 @@ int Thread::idle()
                 CPU::halt();
             }
         } else {
+            // Zero frames for MMU::calloc() before going to sleep (idle only runs on CPU 0, see Thread::init())
+            while(MMU::prezero());
+
             CPU::int_enable();
+
+            if(IC::statistics && IC::dump_due())
+                IC::dump_stats();
+
             CPU::halt();
         }
     }
@@ -365,6 +521,72 @@ int Thread::idle()
     return 0;
 }
 
+
+// Lists the stacks of every thread grouped by Task and the occupation of the heaps
+// (printed through kout, i.e. on the UART when Traits<Serial_Display>::enabled)
+void Thread::memory_report()
+{
+    typedef Simple_List<Thread>::Element Element;
+
+    kout << "Memory report:" << endl;
+
+    for(Element * e = Task::_threads.head(); e; e = e->next()) {
+        Task * task = e->object()->_task;
+
+        // Report each task once, when its first thread shows up
+        bool reported = false;
+        for(Element * p = Task::_threads.head(); p != e; p = p->next())
+            if(p->object()->_task == task)
+                reported = true;
+        if(reported)
+            continue;
+
+        unsigned int threads = 0, stacks = 0, heap = 0, peak = 0;
+        for(Element * t = e; t; t = t->next()) {
+            Thread * thread = t->object();
+            if(thread->_task != task)
+                continue;
+            threads++;
+            stacks += thread->_stack_size;
+            if(!thread->_stack_segment)
+                heap += thread->_stack_size;
+            peak += thread->stack_peak();
+        }
+
+        kout << "  Task " << task << ": threads=" << threads
+             << ",stacks=" << stacks << " (heap=" << heap << ",peak=" << peak << ")" << endl;
+
+        for(Element * t = e; t; t = t->next()) {
+            Thread * thread = t->object();
+            if(thread->_task != task)
+                continue;
+            kout << "    Thread " << thread << ": state=" << thread->_state
+                 << ",stack={b=" << reinterpret_cast<void *>(thread->_stack)
+                 << ",s=" << thread->_stack_size
+                 << ",used=" << thread->stack_used()
+                 << ",peak=" << thread->stack_peak() << "}" << endl;
+        }
+    }
+
+    kout << "  System heap " << System::_heap << ": size=" << System::_heap->capacity()
+         << ",used=" << System::_heap->allocated() << ",free=" << System::_heap->available() << endl;
+    if(Traits<System>::multiheap && Application::_heap)
+        kout << "  Application heap " << Application::_heap << ": size=" << Application::_heap->capacity()
+             << ",used=" << Application::_heap->allocated() << ",free=" << Application::_heap->available() << endl;
+    if(Traits<Scratchpad>::enabled)
+        kout << "  Scratchpad heap: size=" << Scratchpad::size() << ",used=" << Scratchpad::used()
+             << ",peak=" << Scratchpad::peak() << ",allocations=" << Scratchpad::allocations()
+             << ",misses=" << Scratchpad::misses() << endl;
+
+    // Binary heap profiles for tools/eposheap
+    if(Traits<Heaps>::profiled) {
+        UART uart;
+        System::_heap->dump(uart);
+        if(Traits<System>::multiheap && Application::_heap)
+            Application::_heap->dump(uart);
+    }
+}
+
 __END_SYS
 
 // Id forwarder to the spin lock
@@ -18,22 +18,37 @@ void Thread::init()
 
     db<Init, Thread>(TRC) << "Thread::init(entry=" << reinterpret_cast<void *>(entry) << ")" << endl;
 
+    // The scheduler keeps a single chosen thread, which running() returns on any CPU, so only CPU 0 runs threads.
+    // The other CPUs never call into Thread (no lock, sleep or wakeup, which would act on CPU 0's thread): once CPU 0
+    // has created its threads, they just halt and serve cross-CPU calls (see IC::call())
+    if(Machine::cpu_id() != 0) {
+        Machine::smp_barrier();
+        CPU::int_enable();
+        while(true)
+            CPU::halt();
+    }
+
     // The installation of the scheduler timer handler must precede the
     // creation of threads, since the constructor can induce a reschedule
     // and this in turn can call timer->reset()
     // Letting reschedule() happen during thread creation is harmless, since
     // MAIN is created first and dispatch won't replace it nor by itself
     // neither by IDLE (that has a lower priority)
-    if(Criterion::timed && (Machine::cpu_id() == 0))
+    if(Criterion::timed)
         _timer = new (SYSTEM) Scheduler_Timer(QUANTUM, time_slicer);
 
-    Thread * first;
+    // FPU/SSE contexts are switched lazily, on the first use after each dispatch
+    if(CPU::fpu && CPU::fpu_supported())
+        IC::int_vector(CPU::EXC_NODEV, fpu_switch);
+
     // Create the application's main thread
     // This must precede idle, thus avoiding implicit rescheduling
     // For preemptive scheduling, reschedule() is called, but it will preserve MAIN as the RUNNING thread
-    first = new (SYSTEM) Thread(Task::_master, Configuration(RUNNING, MAIN), entry);
+    Thread * first = new (SYSTEM) Thread(Task::_master, Configuration(RUNNING, MAIN), entry);
     new (SYSTEM) Thread(Task::_master, Configuration(READY, IDLE), &idle);
 
+    Machine::smp_barrier();
+
     db<Init, Thread>(INF) << "Dispatching the first thread: " << first << endl;
 
     This_Thread::not_booting();
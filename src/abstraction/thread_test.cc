@@ -35,6 +35,9 @@ int main()
     cout << "Thread A exited with status " << status_a 
          << " and thread B exited with status " << status_b << "" << endl;
 
+    cout << "Stack peaks: A=" << a->stack_peak() << ", B=" << b->stack_peak()
+         << ", main=" << Thread::self()->stack_peak() << " bytes" << endl;
+
     delete a;
     delete b;
     delete m;
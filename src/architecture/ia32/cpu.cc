@@ -16,15 +16,10 @@ void IA32::Context::save() volatile
     ASM("     push    %ebp                                            \n"
         "     mov     %esp, %ebp                                      \n"
         "     mov     8(%ebp), %esp   # sp = this                     \n"
-        "     add     $40, %esp       # sp += sizeof(Context)         \n"
+        "     add     $20, %esp       # sp += sizeof(Context)         \n"
         "     push    4(%ebp)         # push eip                      \n"
-        "     pushf                                                   \n"
-        "     push    %eax                                            \n"
-        "     push    %ecx                                            \n"
-        "     push    %edx                                            \n"
-        "     push    %ebx                                            \n"
-        "     push    %ebp            # push esp                      \n"
         "     push    (%ebp)          # push ebp                      \n"
+        "     push    %ebx                                            \n"
         "     push    %esi                                            \n"
         "     push    %edi                                            \n"
         "     mov     %ebp, %esp                                      \n"
@@ -34,27 +29,55 @@ void IA32::Context::save() volatile
 void IA32::Context::load() const volatile
 {
     // Pop the context pushed into the stack during thread creation to initialize the CPU's context
-    // Obs: POPA ignores the ESP saved by PUSHA. ESP is just normally incremented
+    // The RET pops _eip, which for a new thread is Full_Context::load()
     ASM("       mov     4(%esp), %esp       # sp = this             \n"
-        "       popa                                                \n"
-        "       popf                                                \n");
+        "       pop     %edi                                        \n"
+        "       pop     %esi                                        \n"
+        "       pop     %ebx                                        \n"
+        "       pop     %ebp                                        \n"
+        "       ret                                                 \n");
+}
+
+void IA32::Full_Context::load()
+{
+    // Reached through a RET with sp = this, never called
+    // Obs: POPA ignores the ESP saved by PUSHA. ESP is just normally incremented
+    ASM("       popa                                                \n"
+        "       popf                                                \n"
+        "       ret                                                 \n");
+}
+
+void IA32::switch_context_lean(Context * volatile * o, Context * volatile n)
+{
+    // Only the callee-saved registers must survive a call, so that is all a thread switching from C code
+    // (i.e. Thread::dispatch()) needs to save. The return address pushed by the call completes the Context.
+    ASM("       push    %ebp                                    \n"
+        "       push    %ebx                                    \n"
+        "       push    %esi                                    \n"
+        "       push    %edi                                    \n"
+        "       mov     20(%esp), %eax          # old           \n"
+        "       mov     %esp, (%eax)                            \n"
+        "       mov     24(%esp), %esp          # new           \n"
+        "       pop     %edi                                    \n"
+        "       pop     %esi                                    \n"
+        "       pop     %ebx                                    \n"
+        "       pop     %ebp                                    \n"
+        "       ret                                             \n");
 }
 
 void IA32::switch_context(Context * volatile * o, Context * volatile n)
 {
-    // Save the previously running thread context ("o") into its stack 
-    // and updates the its _context attribute
+    // Save the whole register set of the previously running thread ("o") into its stack, then let the lean
+    // switch stack a Context on top of it, so a thread saved here can be resumed by either switch and vice-versa
     // PUSHA saves an extra "esp" (which is always "this"), but saves several instruction fetches
     ASM("	pushf                  		                \n"
-        "	pusha				                \n");
-    ASM("       mov     40(%esp), %eax          # old           \n"
-        "       mov     %esp, (%eax)                            \n");
-
-    // Restore the next thread context ("n") from its stack (and the user-level stack pointer, updating the dummy TSS)
-    ASM("	mov     44(%esp), %esp          # new	        \n");
-    ASM("	popa				                \n"
-        "	popf			                	\n");
-    ASM("       mov     %%esp, %0                               \n" : "=m"(Thread::running()->_context) : );
+        "	pusha				                \n"
+        "       push    44(%%esp)               # new           \n"
+        "       push    44(%%esp)               # old           \n"
+        "       call    %P0                                     \n"
+        "       add     $8, %%esp                               \n"
+        "	popa				                \n"
+        "	popf			                	\n" : : "i"(switch_context_lean));
 }
 
 __END_SYS
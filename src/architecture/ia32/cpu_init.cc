@@ -3,6 +3,7 @@
 #include <cpu.h>
 #include <tsc.h>
 #include <mmu.h>
+#include <machine.h>
 #include <system.h>
 #include <system/info.h>
 
@@ -15,6 +16,22 @@ void IA32::init()
     _cpu_clock = System::info()->tm.cpu_clock;
     _bus_clock = System::info()->tm.bus_clock;
 
+    // Let the FPU and SSE run natively, but trap their first use after each dispatch (see Thread::fpu_switch())
+    if(fpu) {
+        if(fpu_supported()) {
+            cr0((cr0() & ~CR0_EM) | CR0_MP | CR0_NE | CR0_TS);
+            cr4(cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+        } else
+            db<Init, CPU>(WRN) << "CPU::init: no FXSR/SSE, FPU contexts won't be switched!" << endl;
+    }
+
+    // The rest is shared by all CPUs, so it is initialized by the bootstrap CPU only (see Init_System)
+    if(Machine::cpu_id() != 0)
+        return;
+
+    // Derive the clock source's conversion factors from the calibrated CPU clock
+    TSC::init();
+
     // Initialize the MMU
     if(Traits<MMU>::enabled)
         MMU::init();
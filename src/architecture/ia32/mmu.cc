@@ -6,6 +6,109 @@ __BEGIN_SYS
 
 // Class attributes
 IA32_MMU::List IA32_MMU::_free;
+IA32_MMU::Zeroed_List IA32_MMU::_zeroed;
+unsigned int IA32_MMU::_zeroed_hits;
+unsigned int IA32_MMU::_zeroed_misses;
 IA32_MMU::Page_Directory * IA32_MMU::_master;
+Bitmap<IA32_MMU::PD_ENTRIES> IA32_MMU::_master_used;
+volatile unsigned int * IA32_MMU::_refs;
+unsigned int IA32_MMU::_frames;
+unsigned int IA32_MMU::_budget = IA32_MMU::ALL_COLOURS;
+unsigned int IA32_MMU::_budget_size = IA32_MMU::COLOURS;
+unsigned int IA32_MMU::_colour_misses;
+
+// Class methods
+bool IA32_MMU::fault(Log_Addr addr)
+{
+    PD_Entry pde = (*current())[directory(addr)];
+    if(!(pde & IA32_Flags::PRE) || (pde & IA32_Flags::PS))
+        return false;
+
+    Page_Table * pt = reinterpret_cast<Page_Table *>((unsigned int)indexes(pde));
+    volatile unsigned int & pte = reinterpret_cast<volatile unsigned int &>((*pt)[page(addr)]);
+    unsigned int reserved = pte;
+    if(reserved & IA32_Flags::PRE) {
+        if(!(reserved & IA32_Flags::COW))
+            return false;
+
+        // Device frames are never shared, so COW | IO marks a page whose fault another CPU is resolving:
+        // the faulting access is simply retried until that CPU is done
+        if(reserved & IA32_Flags::IO)
+            return true;
+
+        // The PTE is claimed before the frame is unshared, so two CPUs faulting on the same page can't both
+        // drop a mapping of it (and free a frame that is still mapped elsewhere)
+        if(CPU::cas(pte, reserved, reserved | IA32_Flags::IO) != reserved)
+            return true;
+
+        Phy_Addr shared = indexes(reserved);
+        unsigned int flags = ((reserved & (sizeof(Page) - 1)) & ~IA32_Flags::COW) | IA32_Flags::RW;
+        Phy_Addr frame = shared;
+        if(unshare(shared)) { // others still map it, so the writer gets a copy
+            frame = alloc();
+            if(!frame) {
+                share(shared);
+                pte = reserved;
+                return false;
+            }
+            memcpy(phy2log(frame), phy2log(shared), sizeof(Page));
+        }
+        pte = (unsigned int)frame | flags;
+
+        flush_tlb(addr);
+
+        db<IA32_MMU>(TRC) << "IA32_MMU::fault(addr=" << addr << ") => copy-on-write " << shared << " => " << frame << endl;
+
+        return true;
+    }
+
+    if(!reserved)
+        return false;
+
+    Phy_Addr frame;
+    if(colouring) {
+        frame = alloc_coloured(budget_colour(addr >> PAGE_SHIFT));
+        if(frame)
+            memset(phy2log(frame), 0, sizeof(Page));
+    } else
+        frame = calloc();
+    if(!frame)
+        return false;
+
+    // Another CPU might have resolved the same fault in the meantime
+    if(CPU::cas(pte, reserved, (unsigned int)frame | reserved | IA32_Flags::PRE) != reserved)
+        free(frame);
+
+    flush_tlb(addr);
+
+    db<IA32_MMU>(TRC) << "IA32_MMU::fault(addr=" << addr << ") => " << frame << endl;
+
+    return true;
+}
+
+
+IA32_MMU::Phy_Addr IA32_MMU::alloc_coloured(unsigned int colour)
+{
+    // Free blocks are split around the highest frame of the colour they hold
+    for(List::Element * e = _free.head(); e; e = e->next()) {
+        unsigned int first = reinterpret_cast<unsigned int>(e->object()) >> PAGE_SHIFT;
+        unsigned int last = first + e->size() - 1;
+        unsigned int frame = last - ((last - colour) & (COLOURS - 1));
+        if((frame < first) || (frame > last))
+            continue;
+
+        _free.decrement(e, last - frame + 1);
+        Phy_Addr phy = frame << PAGE_SHIFT;
+        free(phy + sizeof(Frame), last - frame);
+
+        db<IA32_MMU>(TRC) << "IA32_MMU::alloc_coloured(colour=" << colour << ") => " << phy << endl;
+
+        return phy;
+    }
+
+    _colour_misses++;
+
+    return alloc();
+}
 
 __END_SYS
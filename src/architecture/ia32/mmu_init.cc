@@ -36,8 +36,15 @@ void IA32_MMU::init()
     free(si->pmm.free2_base, pages(si->pmm.free2_top - si->pmm.free2_base));
     free(si->pmm.free3_base, pages(si->pmm.free3_top - si->pmm.free3_base));
 
+    // Allocate the per-frame sharing counters used by copy-on-write
+    _frames = pages(si->bm.mem_top);
+    _refs = reinterpret_cast<volatile unsigned int *>((void *)phy2log(calloc(pages(_frames * sizeof(unsigned int)))));
+
     // Remeber the master page directory (created during SETUP)
     _master = reinterpret_cast<Page_Directory *>(CPU::pdp());
+    for(unsigned int i = 0; i < PD_ENTRIES; i++)
+        if((*_master)[i])
+            _master_used.set(i);
 
     db<Init, IA32_MMU>(INF) << "IA32_MMU::master page directory=" << _master << endl;
 }
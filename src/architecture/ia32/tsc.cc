@@ -0,0 +1,28 @@
+// EPOS IA32 Time-Stamp Counter Mediator Implementation
+
+#include <tsc.h>
+
+__BEGIN_SYS
+
+// Class attributes
+IA32_TSC::Scale IA32_TSC::_ns;
+IA32_TSC::Scale IA32_TSC::_us;
+IA32_TSC::Time_Stamp IA32_TSC::_overhead;
+
+// Methods
+// "mult" gets the largest "shift" that still fits it in 32 bits, thus the best precision
+void IA32_TSC::Scale::set(Hertz from, unsigned long to)
+{
+    for(shift = 63; shift > 0; shift--) {
+        if(to >= (1ULL << (64 - shift))) // "to << shift" must not overflow
+            continue;
+        unsigned long long m = ((static_cast<unsigned long long>(to) << shift) + from / 2) / from; // rounded
+        if(m <= 0xffffffffULL) {
+            mult = m;
+            return;
+        }
+    }
+    mult = to / from;
+}
+
+__END_SYS
@@ -0,0 +1,28 @@
+// EPOS IA32 Time-Stamp Counter Mediator Initialization
+
+#include <tsc.h>
+
+__BEGIN_SYS
+
+void IA32_TSC::init()
+{
+    db<Init, IA32_TSC>(TRC) << "TSC::init()" << endl;
+
+    // CPU::clock() was calibrated against the i8253 by SETUP
+    _ns.set(frequency(), 1000000000);
+    _us.set(frequency(), 1000000);
+
+    // The cheapest of a few back-to-back reads is what a measurement costs by itself
+    _overhead = ~0ULL;
+    for(unsigned int i = 0; i < 16; i++) {
+        Time_Stamp t0 = serialized_time_stamp();
+        Time_Stamp t1 = serialized_time_stamp();
+        if(t1 - t0 < _overhead)
+            _overhead = t1 - t0;
+    }
+
+    db<Init, IA32_TSC>(INF) << "TSC::init:frequency=" << frequency() << " Hz,ns={mult=" << _ns.mult << ",shift=" << _ns.shift
+                            << "},overhead=" << _overhead << " ticks" << endl;
+}
+
+__END_SYS
@@ -27,7 +27,7 @@ public:
             Application::_heap = new (&Application::_preheap[0]) Heap(heap, HEAP_SIZE);
         } else
             for(unsigned int frames = MMU::allocable(); frames; frames = MMU::allocable())
-                System::_heap->free(MMU::alloc(frames), frames * sizeof(MMU::Page));
+                System::_heap->grow(MMU::alloc(frames), frames * sizeof(MMU::Page));
         db<Init>(INF) << "done!" << endl;
     }
 };
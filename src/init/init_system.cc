@@ -17,6 +17,9 @@ private:
 
 public:
     Init_System() {
+        // All CPUs run INIT, so they must first know how many of them are there and who they are
+        Machine::smp_init(System::info()->bm.n_cpus);
+
         db<Init>(TRC) << "Init_System()" << endl;
 
         // Initialize the processor
@@ -24,6 +27,12 @@ public:
         CPU::init();
         db<Init>(INF) << "done!" << endl;
 
+        // The rest is shared, so it is initialized once, while the other CPUs wait
+        if(Machine::cpu_id() != 0) {
+            Machine::smp_barrier();
+            return;
+        }
+
         // Initialize System's heap
         db<Init>(INF) << "Initializing system's heap: " << endl;
         if(Traits<System>::multiheap) {
@@ -54,6 +63,8 @@ public:
             db<Init>(INF) << "done!" << endl;
         }
 
+        Machine::smp_barrier();
+
         // Initialization continues at init_first
     }
 };
@@ -6,7 +6,35 @@
 
 __BEGIN_SYS
 
+// Class attributes
 Segment * Scratchpad_Common::_segment;
 Heap * Scratchpad_Common::_heap;
+char * Scratchpad_Common::_base;
+unsigned int Scratchpad_Common::_peak;
+unsigned int Scratchpad_Common::_allocations;
+unsigned int Scratchpad_Common::_misses;
+
+// Class methods
+void * Scratchpad_Common::alloc(unsigned int bytes)
+{
+    // Heap::alloc() panics when it runs out of memory, so check first
+    if(_heap && _heap->fits(bytes)) {
+        void * addr = _heap->alloc(bytes);
+        _allocations++;
+        if(_heap->allocated() > _peak)
+            _peak = _heap->allocated();
+
+        db<Scratchpad>(TRC) << "Scratchpad::alloc(bytes=" << bytes << ") => " << addr << endl;
+
+        return addr;
+    }
+
+    _misses++;
+    void * addr = new (SYSTEM) char[bytes];
+
+    db<Scratchpad>(INF) << "Scratchpad::alloc(bytes=" << bytes << "): scratchpad full, using the system heap => " << addr << endl;
+
+    return addr;
+}
 
 __END_SYS
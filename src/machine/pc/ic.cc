@@ -2,14 +2,27 @@
 
 #include <machine/pc/ic.h>
 #include <machine.h>
+#include <mmu.h>
 
 extern "C" { void _exit(int s); }
 
 __BEGIN_SYS
 
 // Class attributes
+i8259A::Reg16 i8259A::_imr;
+volatile i8259A::Reg16 i8259A::_nested;
 APIC::Log_Addr APIC::_base;
+IO_APIC::Log_Addr IO_APIC::_base;
 PC_IC::Interrupt_Handler PC_IC::_int_vector[PC_IC::INTS];
+CPU::TSS PC_IC::_pf_tss;
+char PC_IC::_pf_stack[4096];
+PC_IC::Statistics PC_IC::_stats[PC_IC::INTS];
+PC_IC::Histogram PC_IC::_wakeup;
+volatile TSC::Time_Stamp PC_IC::_timer_stamp;
+unsigned int PC_IC::_ticks;
+volatile bool PC_IC::_dump_due;
+PC_IC::Frame * PC_IC::_frames[Traits<Machine>::CPUS];
+PC_IC::Mailbox PC_IC::_mailbox[Traits<Machine>::CPUS];
 
 
 // Class methods
@@ -29,6 +42,10 @@ void PC_IC::exc_not(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Re
 
 void PC_IC::exc_pf(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Reg32 eflags)
 {  
+    // Not-present faults on pages reserved by lazy segments are resolved on demand
+    if((i == CPU::EXC_PF) && MMU::fault(CPU::cr2()))
+        return;
+
     db<IC>(WRN) << "IC::exc_pf(i=" << i << ") => [address=" << hex << CPU::cr2() << ",err={";
     if(error & (1 << 0))
         db<IC>(WRN) << "P";
@@ -44,6 +61,39 @@ void PC_IC::exc_pf(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Reg
     _exit(-1);
 }
 
+// A page fault on a lazy stack page can't be delivered on that very stack, so with lazy stacks
+// page faults switch to a task of their own. #PF is a fault, so the IRET back to the faulting
+// task (see entry_pf_task()) restarts the faulting instruction
+void PC_IC::exc_pf_task(Reg32 error)
+{
+    CPU::TSS * tss0 = reinterpret_cast<CPU::TSS *>(Memory_Map<PC>::TSS0);
+    Reg32 addr = CPU::cr2();
+
+    // Back into the address space of the faulting thread (tss0->pdbr is updated by MMU::Directory::activate())
+    CPU::pdp(tss0->pdbr);
+
+    if(MMU::fault(addr))
+        return;
+
+    db<IC>(WRN) << "IC::exc_pf_task() => [address=" << hex << addr << ",err=" << error
+                << ",ctx={ip=" << tss0->eip << ",sp=" << tss0->esp << "}]" << endl;
+
+    // Termination would run on the faulting stack, so a fault on (or right below) it is fatal
+    if((addr + sizeof(MMU::Page) > tss0->esp) && (addr < tss0->esp + sizeof(MMU::Page))) {
+        db<IC>(ERR) << "IC::exc_pf_task(): stack overflow!" << endl;
+        Machine::panic();
+    }
+
+    db<IC>(WRN) << "The running thread will now be terminated!" << endl;
+    tss0->eip = Log_Addr(&pf_exit);
+}
+
+// Where the faulting task resumes when exc_pf_task() can't resolve the fault
+void PC_IC::pf_exit()
+{
+    _exit(-1);
+}
+
 void PC_IC::exc_gpf(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Reg32 eflags)
 {  
     db<IC>(WRN) << "IC::exc_gpf(i=" << i << ")[err=" << hex << error << ",ctx={cs=" << (void *)cs
@@ -62,67 +112,202 @@ void PC_IC::exc_fpu(const Interrupt_Id & i, Reg32 error, Reg32 eip, Reg32 cs, Re
     _exit(-1);
 }
 
-// APIC class methods
-void APIC::ipi_init(volatile int * status)
+void PC_IC::enter(Frame * f, unsigned int i)
 {
-//    // Broadcast INIT IPI to all APs excluding self
-//    write(ICR0_31, ICR_OTHERS | ICR_LEVEL | ICR_ASSERT | ICR_INIT);
-//    while((read(ICR0_31) & ICR_PENDING));
+    unsigned int cpu = Machine::cpu_id();
 
-    status[0] = 0;
+    f->i = i;
+    f->start = TSC::time_stamp();
+    f->outer = _frames[cpu];
+    _frames[cpu] = f;
 
-    // Send INIT IPI to all APs excluding self
-    for(unsigned int n = 1; n < Traits<PC>::CPUS; n++) {
-        status[n] = 0;
-        write(ICR32_63, n << 24);
-        write(ICR0_31, ICR_LEVEL | ICR_ASSERT | ICR_INIT);
-        while((read(ICR0_31) & ICR_PENDING));
+    if(i == INT_TIMER)
+        _timer_stamp = f->start;
+}
+
+// Might run long after enter(), on another CPU, if the handler switched threads, but then switching() has already
+// accounted for this frame (and for the outer ones, so putting them back on this CPU's list is harmless)
+void PC_IC::leave(Frame * f)
+{
+    _frames[Machine::cpu_id()] = f->outer;
+
+    if(f->start)
+        account(f->i, TSC::time_stamp() - f->start);
+
+    if(f->i == INT_TIMER)
+        _timer_stamp = 0; // no thread woke up within this interrupt (see wakeup())
+}
+
+void PC_IC::switching()
+{
+    TSC::Time_Stamp now = TSC::time_stamp();
+    unsigned int cpu = Machine::cpu_id();
+
+    for(Frame * f = _frames[cpu]; f; f = f->outer)
+        if(f->start) {
+            account(f->i, now - f->start);
+            f->start = 0;
+        }
+    _frames[cpu] = 0;
+}
+
+void PC_IC::account(unsigned int i, unsigned long cycles)
+{
+    _stats[i].count++;
+    _stats[i].duration.add(cycles);
+
+    if((i == INT_TIMER) && Traits<PC_IC>::statistics_dump
+       && (++_ticks >= Traits<PC_IC>::statistics_dump * Traits<PC_Timer>::FREQUENCY)) {
+        _ticks = 0;
+        _dump_due = true;
+    }
+}
+
+// Printed through kout, i.e. on the UART when Traits<Serial_Display>::enabled
+void PC_IC::dump_stats()
+{
+    kout << "Interrupt statistics (TSC cycles; bucket n counts [2^(n+6),2^(n+7))):" << endl;
+    for(unsigned int i = 0; i < INTS; i++) {
+        if(!_stats[i].count)
+            continue;
+        kout << "  " << i << ": n=" << _stats[i].count << ", max=" << _stats[i].duration.max << ", h=";
+        for(unsigned int b = 0; b < BUCKETS; b++)
+            kout << " " << _stats[i].duration.bucket[b];
+        kout << endl;
+    }
+
+    unsigned int n = 0;
+    for(unsigned int b = 0; b < BUCKETS; b++)
+        n += _wakeup.bucket[b];
+    kout << "  timer to thread: n=" << n << ", max=" << _wakeup.max << ", h=";
+    for(unsigned int b = 0; b < BUCKETS; b++)
+        kout << " " << _wakeup.bucket[b];
+    kout << endl;
+}
+
+void PC_IC::call(unsigned int cpus, Call * f, void * arg, bool wait)
+{
+    db<IC>(TRC) << "IC::call(cpus=" << hex << cpus << dec << ",f=" << reinterpret_cast<void *>(f) << ",arg=" << arg
+                << ",wait=" << wait << ")" << endl;
+
+    // Interrupts are disabled so the INT_RESCHEDULER handler can't take this CPU's mailbox while we hold it
+    bool enabled = CPU::int_enabled();
+    CPU::int_disable();
+
+    volatile unsigned int ack = 0;
+    unsigned int n = 0;
+    unsigned int self = Machine::cpu_id();
+    for(unsigned int cpu = 0; cpu < Machine::n_cpus(); cpu++)
+        if((cpus & (1 << cpu)) && (cpu != self)) {
+            post(cpu, f, arg, wait ? &ack : 0);
+            n++;
+        }
+
+    if(cpus & (1 << self))
+        f(arg);
+
+    // Serve requests from other CPUs while waiting, since they might be waiting for us too
+    if(wait)
+        while(ack < n)
+            serve();
+
+    if(enabled)
+        CPU::int_enable();
+}
+
+
+void PC_IC::post(unsigned int cpu, Call * f, void * arg, volatile unsigned int * ack)
+{
+    Mailbox & m = _mailbox[cpu];
+
+    while(true) {
+        while(CPU::tsl(m.lock));
+        if(m.tail - m.head < CALLS)
+            break;
+        m.lock = false;
+        serve(); // the target might be trying to post to us
     }
 
-    i8255::ms_delay(100);
+    bool idle = (m.head == m.tail);
+    Request & r = m.request[m.tail % CALLS];
+    r.function = f;
+    r.arg = arg;
+    r.ack = ack;
+    m.tail = m.tail + 1;
+    m.lock = false;
+
+    if(idle)
+        ipi_send(cpu, INT_RESCHEDULER);
+}
+
+
+// INT_RESCHEDULER's handler on multicores (remote reschedules need a chosen thread per CPU, which the scheduler doesn't have yet)
+void PC_IC::int_call(const Interrupt_Id & i)
+{
+    serve();
+}
+
+// Runs the calls pending for this CPU
+void PC_IC::serve()
+{
+    Mailbox & m = _mailbox[Machine::cpu_id()];
+
+    while(true) {
+        while(CPU::tsl(m.lock));
+        if(m.head == m.tail) {
+            m.lock = false;
+            return;
+        }
+        Request r = m.request[m.head % CALLS];
+        m.head = m.head + 1;
+        m.lock = false;
+
+        r.function(r.arg);
+        if(r.ack)
+            CPU::finc(*r.ack);
+    }
+}
+
+// APIC class methods
+void APIC::ipi_init(volatile int * status)
+{
+    for(unsigned int n = 0; n < Traits<PC>::CPUS; n++)
+        status[n] = 0;
+
+    // Broadcast INIT IPI to all APs excluding self
+    write(ICR0_31, ICR_OTHERS | ICR_LEVEL | ICR_ASSERT | ICR_INIT);
+    while((read(ICR0_31) & ICR_PENDING));
+
+    // The MP specification asks for 10 ms before the first STARTUP IPI
+    i8255::ms_delay(10);
 };
 
 void APIC::ipi_start(Log_Addr entry, volatile int * status)
 {
-//    unsigned int vector = (entry >> 12) & 0xff;
-//
-//    // Broadcast STARTUP IPI to all APs excluding self twice
-//    write(ICR0_31, ICR_OTHERS | ICR_LEVEL | ICR_ASSERT | ICR_STARTUP | vector);
-//    while((read(ICR0_31) & ICR_PENDING));
-//
-//    i8255::ms_delay(10); // ~ 10ms delay
-//
-//    write(ICR0_31, ICR_OTHERS | ICR_LEVEL | ICR_ASSERT | ICR_STARTUP | vector);
-//    while((read(ICR0_31) & ICR_PENDING));
-//
-//    // Give other CPUs a time to wake up (> 100ms)
-//    i8255::ms_delay(100);
-
     unsigned int vector = (entry >> 12) & 0xff;
 
-    // Send STARTUP IPI to all APs
-    for(unsigned int n = 1; n < Traits<PC>::CPUS; n++) {
-        write(ICR32_63, n << 24);
-        write(ICR0_31, ICR_LEVEL | ICR_ASSERT | ICR_STARTUP | vector);
+    // Broadcast STARTUP IPI to all APs excluding self twice (a CPU that took the first one ignores the second)
+    for(unsigned int i = 0; i < 2; i++) {
+        write(ICR0_31, ICR_OTHERS | ICR_LEVEL | ICR_ASSERT | ICR_STARTUP | vector);
         while((read(ICR0_31) & ICR_PENDING));
+        i8255::ms_delay(1); // > 200 us
     }
 
-    // Give them time to wake up (> 100ms)
-    i8255::ms_delay(500);
+    // All APs wake up together, so wait for them as a group (giving up on missing ones after ~100 ms)
+    for(unsigned int ms = 0; ms < 100; ms++) {
+        unsigned int up = 0;
+        for(unsigned int n = 1; n < Traits<PC>::CPUS; n++)
+            if(status[n] == 1)
+                up++;
+        if(up == Traits<PC>::CPUS - 1)
+            break;
+        i8255::ms_delay(1);
+    }
 
-    for(unsigned int n = 1; n < Traits<PC>::CPUS; n++) {
-        if(status[n] == 1) { // CPU is up
+    // Acknowledge them all at once (those still at 0 were not initialized)
+    for(unsigned int n = 1; n < Traits<PC>::CPUS; n++)
+        if(status[n] == 1) // CPU is up
             CPU::finc(status[n]);
-            i8255::ms_delay(30);
-        } else { // send a second STARTUP IPI to the CPU
-            write(ICR32_63, n << 24);
-            write(ICR0_31, ICR_LEVEL | ICR_ASSERT | ICR_STARTUP | vector);
-            i8255::ms_delay(500);
-            if(status[n] == 1) // CPU is up
-                CPU::finc(status[n]);
-            // else CPU was not initialized
-        }
-    }
 }
 
 void APIC::ipi_send(unsigned int cpu, unsigned int interrupt)
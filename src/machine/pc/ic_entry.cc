@@ -6,787 +6,1045 @@ __BEGIN_SYS
 
 void PC_IC::entry()
 {
-    // id must be static because we don't have a stack frame
-    static int id;
-
+    // Each stub pushes its vector number (and a null error code for the vectors for which the CPU doesn't push one),
+    // so the frame is the same for all of them and nothing is kept out of the stack (i.e. this is reentrant)
     ASM("        .align 16              \n"
-        "        movl        $0, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $0          \n"
+        "        jmp        .GO         \n"
+        "        .align 16              \n"
+        "        pushl      $0          \n"
+        "        pushl      $1          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $1, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $2          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $2, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $3          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $3, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $4          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $4, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $5          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $5, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $6          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $6, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $7          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $7, %0     \n"
+        "        pushl      $8          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $8, %0     \n"
+        "        pushl      $0          \n"
+        "        pushl      $9          \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $9, %0     \n"
+        "        pushl      $10         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $10, %0    \n"
+        "        pushl      $11         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $11, %0    \n"
+        "        pushl      $12         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $12, %0    \n"
+        "        pushl      $13         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $13, %0    \n"
+        "        pushl      $14         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $14, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $15         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $15, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $16         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $16, %0    \n"
+        "        pushl      $17         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $17, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $18         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $18, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $19         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $19, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $20         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $20, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $21         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $21, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $22         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $22, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $23         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $23, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $24         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $24, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $25         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $25, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $26         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $26, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $27         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $27, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $28         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $28, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $29         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $29, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $30         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $30, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $31         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $31, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $32         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $32, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $33         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $33, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $34         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $34, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $35         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $35, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $36         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $36, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $37         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $37, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $38         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $38, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $39         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $39, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $40         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $40, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $41         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $41, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $42         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $42, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $43         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $43, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $44         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $44, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $45         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $45, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $46         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $46, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $47         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $47, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $48         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $48, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $49         \n"
         "        jmp        .GO         \n"
         "        .align 16              \n"
-        "        movl        $49, %0    \n"
+        "        pushl      $0          \n"
+        "        pushl      $50         \n"
         // On a regular PC, only the first 32 exceptions and the subsequent 16 interrupts are useful
-        // We also left two spare entries for multicore IPIs and an interrupt-based system call mechanism
-        //        "        jmp        .GO         \n"
-        //        "        .align 16              \n"
-        //        "        movl        $50, %0    \n"
+        // We also left three spare entries for the local APIC timer, multicore IPIs and an interrupt-based system call mechanism
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $51, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $51         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $52, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $52         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $53, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $53         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $54, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $54         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $55, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $55         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $56, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $56         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $57, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $57         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $58, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $58         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $59, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $59         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $60, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $60         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $61, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $61         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $62, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $62         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $63, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $63         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $64, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $64         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $65, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $65         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $66, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $66         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $67, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $67         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $68, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $68         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $69, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $69         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $70, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $70         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $71, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $71         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $72, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $72         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $73, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $73         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $74, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $74         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $75, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $75         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $76, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $76         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $77, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $77         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $78, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $78         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $79, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $79         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $80, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $80         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $81, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $81         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $82, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $82         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $83, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $83         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $84, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $84         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $85, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $85         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $86, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $86         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $87, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $87         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $88, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $88         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $89, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $89         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $90, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $90         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $91, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $91         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $92, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $92         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $93, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $93         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $94, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $94         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $95, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $95         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $96, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $96         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $97, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $97         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $98, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $98         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $99, %0    \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $99         \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $100, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $100        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $101, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $101        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $102, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $102        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $103, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $103        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $104, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $104        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $105, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $105        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $106, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $106        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $107, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $107        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $108, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $108        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $109, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $109        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $110, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $110        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $111, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $111        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $112, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $112        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $113, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $113        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $114, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $114        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $115, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $115        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $116, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $116        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $117, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $117        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $118, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $118        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $119, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $119        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $120, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $120        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $121, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $121        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $122, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $122        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $123, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $123        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $124, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $124        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $125, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $125        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $126, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $126        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $127, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $127        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $128, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $128        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $129, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $129        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $130, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $130        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $131, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $131        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $132, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $132        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $133, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $133        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $134, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $134        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $135, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $135        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $136, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $136        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $137, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $137        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $138, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $138        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $139, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $139        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $140, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $140        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $141, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $141        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $142, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $142        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $143, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $143        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $144, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $144        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $145, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $145        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $146, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $146        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $147, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $147        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $148, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $148        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $149, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $149        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $150, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $150        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $151, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $151        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $152, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $152        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $153, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $153        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $154, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $154        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $155, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $155        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $156, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $156        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $157, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $157        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $158, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $158        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $159, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $159        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $160, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $160        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $161, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $161        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $162, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $162        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $163, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $163        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $164, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $164        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $165, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $165        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $166, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $166        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $167, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $167        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $168, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $168        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $169, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $169        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $170, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $170        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $171, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $171        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $172, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $172        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $173, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $173        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $174, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $174        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $175, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $175        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $176, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $176        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $177, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $177        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $178, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $178        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $179, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $179        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $180, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $180        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $181, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $181        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $182, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $182        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $183, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $183        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $184, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $184        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $185, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $185        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $186, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $186        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $187, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $187        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $188, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $188        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $189, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $189        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $190, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $190        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $191, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $191        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $192, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $192        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $193, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $193        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $194, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $194        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $195, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $195        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $196, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $196        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $197, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $197        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $198, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $198        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $199, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $199        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $200, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $200        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $201, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $201        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $202, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $202        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $203, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $203        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $204, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $204        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $205, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $205        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $206, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $206        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $207, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $207        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $208, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $208        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $209, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $209        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $210, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $210        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $211, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $211        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $212, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $212        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $213, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $213        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $214, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $214        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $215, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $215        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $216, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $216        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $217, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $217        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $218, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $218        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $219, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $219        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $220, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $220        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $221, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $221        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $222, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $222        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $223, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $223        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $224, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $224        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $225, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $225        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $226, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $226        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $227, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $227        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $228, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $228        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $229, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $229        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $230, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $230        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $231, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $231        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $232, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $232        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $233, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $233        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $234, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $234        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $235, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $235        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $236, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $236        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $237, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $237        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $238, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $238        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $239, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $239        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $240, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $240        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $241, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $241        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $242, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $242        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $243, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $243        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $244, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $244        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $245, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $245        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $246, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $246        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $247, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $247        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $248, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $248        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $249, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $249        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $250, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $250        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $251, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $251        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $252, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $252        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $253, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $253        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $254, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $254        \n"
         //        "        jmp        .GO         \n"
         //        "        .align 16              \n"
-        //        "        movl        $255, %0   \n"
+        //        "        pushl      $0          \n"
+        //        "        pushl      $255        \n"
         ".GO:    pushal                 \n"
-        : "=m"(id) : );
-
-    ASM("        pushl  %0              \n"
-        "        call   *%1             \n"
-        "        popl   %%eax           \n"
+        "        pushl  32(%%esp)       \n" // the vector
+        "        call   %P0             \n"
+        "        addl   $4, %%esp       \n"
         "        popal                  \n"
+        "        addl   $8, %%esp       \n" // drop the vector and the error code
         "        iret                   \n"
-        : : "m"(id), "c"(dispatch));
+        : : "i"(dispatch));
 };
 
+// Entry point of the page fault task: the CPU pushes the error code (exc_pf_task()'s argument),
+// IRET (with NT set) resumes the faulting task and the next page fault resumes this one right after it
+void PC_IC::entry_pf_task()
+{
+    ASM("1:      call   %P0             \n"
+        "        addl   $4, %%esp       \n"
+        "        iret                   \n"
+        "        jmp    1b              \n"
+        : : "i"(exc_pf_task));
+}
+
 __END_SYS
@@ -2,6 +2,7 @@
 
 #include <cpu.h>
 #include <ic.h>
+#include <utility/string.h>
 
 __BEGIN_SYS
 
@@ -19,6 +20,29 @@ void PC_IC::init()
         else
             idt[i] = CPU::IDT_Entry(CPU::SEL_SYS_CODE, Log_Addr(entry) + CPU::EXC_LAST * 16, CPU::SEG_IDT_ENTRY);
     
+    // TSS0 must know CR3 for the page fault task, which reloads it (see exc_pf_task())
+    CPU::TSS * tss0 = reinterpret_cast<CPU::TSS *>(Memory_Map<PC>::TSS0);
+    tss0->pdbr = CPU::pdp();
+
+    // With lazy thread stacks, page faults switch to a task of their own (see exc_pf_task())
+    if(pf_task) {
+        memset(&_pf_tss, 0, sizeof(CPU::TSS));
+        _pf_tss.pdbr = CPU::pdp();
+        _pf_tss.eip = Log_Addr(entry_pf_task);
+        _pf_tss.eflags = CPU::FLAG_DEFAULTS & ~CPU::FLAG_IF;
+        _pf_tss.esp = Log_Addr(&_pf_stack[sizeof(_pf_stack)]);
+        _pf_tss.cs = CPU::SEL_SYS_CODE;
+        _pf_tss.ss = CPU::SEL_SYS_DATA;
+        _pf_tss.ds = _pf_tss.ss;
+        _pf_tss.es = _pf_tss.ss;
+        _pf_tss.fs = _pf_tss.ss;
+        _pf_tss.gs = _pf_tss.ss;
+        _pf_tss.io_bmp = sizeof(CPU::TSS);
+        CPU::GDT_Entry * gdt = reinterpret_cast<CPU::GDT_Entry *>(Memory_Map<PC>::GDT);
+        gdt[CPU::GDT_TSS_PF] = CPU::GDT_Entry(Log_Addr(&_pf_tss), sizeof(CPU::TSS) - 1, CPU::SEG_TSS0);
+        idt[CPU::EXC_PF] = CPU::IDT_Entry(CPU::SEL_TSS_PF, 0, CPU::SEG_TASK_GATE);
+    }
+
     // Set all interrupt handlers to int_not()
     for(unsigned int i = 0; i < INTS; i++)
  	_int_vector[i] = int_not;
@@ -29,9 +53,17 @@ void PC_IC::init()
     _int_vector[CPU::EXC_GPF] = reinterpret_cast<Interrupt_Handler>(exc_gpf);
     _int_vector[CPU::EXC_NODEV] = reinterpret_cast<Interrupt_Handler>(exc_fpu);
 
+    // Other CPUs interrupt this one with calls for it to run (see call())
+    if(Traits<System>::multicore)
+        _int_vector[INT_RESCHEDULER] = int_call;
+
     remap();
     disable();
 
+    // On multicores, device interrupts are delivered by the I/O APIC (initially all masked and to the BSP)
+    if(Traits<System>::multicore)
+        IO_APIC::reset(INT_FIRST_HARD);
+
     CPU::int_enable();
 }
 
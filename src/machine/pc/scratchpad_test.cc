@@ -0,0 +1,45 @@
+// EPOS PC_Scratchpad Test Program
+
+#include <utility/ostream.h>
+#include <machine.h>
+#include <thread.h>
+
+using namespace EPOS;
+
+const unsigned int BUFFER_SIZE = 256;
+
+OStream cout;
+
+int worker(int n)
+{
+    int sum = 0;
+    for(int i = 0; i <= n; i++)
+        sum += i;
+    return sum;
+}
+
+int main()
+{
+    cout << "PC_Scratchpad test" << endl;
+
+    cout << "Scratchpad size: " << Scratchpad::size() << " bytes" << endl;
+
+    char * buffer = new (SCRATCHPAD) char[BUFFER_SIZE];
+    cout << "new (SCRATCHPAD) char[" << BUFFER_SIZE << "] => " << reinterpret_cast<void *>(buffer)
+         << (Scratchpad::contains(buffer) ? " (in the scratchpad)" : " (in the system heap)") << endl;
+    for(unsigned int i = 0; i < BUFFER_SIZE; i++)
+        buffer[i] = i;
+
+    Thread * t = new Thread(Thread::Configuration(Thread::READY, Thread::NORMAL, 1024, true), &worker, 100);
+    cout << "Thread with its stack in the scratchpad returned " << t->join() << " (expected 5050)" << endl;
+    delete t;
+
+    cout << "Usage: used=" << Scratchpad::used() << ",peak=" << Scratchpad::peak()
+         << ",allocations=" << Scratchpad::allocations() << ",misses=" << Scratchpad::misses() << endl;
+
+    delete buffer;
+
+    cout << "The End!" << endl;
+
+    return 0;
+}
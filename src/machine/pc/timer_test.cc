@@ -38,6 +38,9 @@ int main()
     cout << "count = " << timer.read() << "" << endl;
     for(int i = 0; i < 10000; i++);
     cout << "count = " << timer.read() << "" << endl;
+
+    if(IC::statistics)
+        IC::dump_stats();
     
     cout << "The End!" << endl;
 
@@ -53,6 +53,9 @@ volatile bool Stacks_Ready = false;
 // PC_Setup Synchronization Globals
 volatile bool Paging_Ready = false;
 
+// Time stamp of the INIT IPI, so SETUP can tell how long bringing all CPUs online took
+TSC::Time_Stamp Boot_Stamp;
+
 //========================================================================
 // PC_Setup
 //
@@ -69,6 +72,7 @@ private:
     static const unsigned int MEM_BASE = Memory_Map<PC>::MEM_BASE;
     static const unsigned int MEM_TOP = Memory_Map<PC>::MEM_TOP;
     static const unsigned int APIC_PHY = APIC::LOCAL_APIC_PHY_ADDR;
+    static const unsigned int IO_APIC_PHY = IO_APIC::IO_APIC_PHY_ADDR;
     static const unsigned int VGA_PHY = Traits<PC_Display>::FRAME_BUFFER_ADDRESS;
 
     // Logical memory map
@@ -116,7 +120,7 @@ private:
     void setup_sys_pt();
     void setup_sys_pd();
     void enable_paging();
-    void setup_tss0();
+    void setup_tss();
 
     void load_parts();
     void call_next();
@@ -192,7 +196,7 @@ PC_Setup::PC_Setup(char * boot_image)
  	APIC::remap(Memory_Map<PC>::APIC);
 
         // Configure a TSS for system calls and inter-level interrupt handling
- 	setup_tss0();
+ 	setup_tss();
 
         // Load EPOS parts (e.g. INIT, SYSTEM, APP)
         load_parts();
@@ -207,10 +211,18 @@ PC_Setup::PC_Setup(char * boot_image)
 
         // Enable paging 
         enable_paging();
+
+        // Configure this CPU's TSS (in parallel with the other APs)
+        setup_tss();
     }
 
     Machine::smp_barrier(si->bm.n_cpus);
 
+    if(Traits<System>::multicore && (cpu_id == 0)) {
+        TSC::Time_Stamp cycles = TSC::time_stamp() - Boot_Stamp;
+        kout << "  CPUs:         " << si->bm.n_cpus << " online in " << cycles / (si->tm.cpu_clock / 1000000) << " us" << endl;
+    }
+
     db<Setup>(INF) << "IP=" << CPU::ip() << endl;
     db<Setup>(INF) << "SP=" << reinterpret_cast<void *>(CPU::sp()) << endl;
     db<Setup>(INF) << "CR0=" << reinterpret_cast<void *>(CPU::cr0()) << endl;
@@ -422,9 +434,14 @@ void PC_Setup::build_pmm()
     // = NP/NPTE_PT * sizeof(Page)
     //   NP = size of physical memory in pages
     //   NPTE_PT = number of page table entries per page table
-    unsigned int mem_size = MMU::pages(si->bm.mem_top - si->bm.mem_base);
-    top_page -= (mem_size + MMU::PT_ENTRIES - 1) / MMU::PT_ENTRIES;
-    si->pmm.phy_mem_pts = top_page * sizeof(Page);
+    // With large pages, the page directory maps 4 MB frames directly
+    if(MMU::large_pages)
+        si->pmm.phy_mem_pts = 0;
+    else {
+        unsigned int mem_size = MMU::pages(si->bm.mem_top - si->bm.mem_base);
+        top_page -= (mem_size + MMU::PT_ENTRIES - 1) / MMU::PT_ENTRIES;
+        si->pmm.phy_mem_pts = top_page * sizeof(Page);
+    }
 
     // Page tables to map the IO address space
     // = NP/NPTE_PT * sizeof(Page)
@@ -433,6 +450,7 @@ void PC_Setup::build_pmm()
     detect_pci(&si->pmm.io_base, &si->pmm.io_top);
     si->pmm.io_top += sizeof(Page); // Add room for APIC (4 kB)
     si->pmm.io_top += 16 * sizeof(Page); // Add room for VGA (64 kB)
+    si->pmm.io_top += sizeof(Page); // Add room for the I/O APIC (4 kB)
     unsigned int io_size = MMU::pages(si->pmm.io_top - si->pmm.io_base);
     top_page -= (io_size + MMU::PT_ENTRIES - 1) / MMU::PT_ENTRIES;
     si->pmm.io_pts = top_page * sizeof(Page);
@@ -546,6 +564,12 @@ void PC_Setup::enable_paging()
     // Reload GDTR with its linear address (one more absurd from Intel!)
     CPU::gdtr(sizeof(Page) - 1, GDT);
 
+    // Enable global pages (PGE) and 4 MB pages (PSE) before any PDE is walked
+    Reg32 cr4 = CPU::cr4() | CPU::CR4_PGE;
+    if(MMU::large_pages)
+        cr4 |= CPU::CR4_PSE;
+    CPU::cr4(cr4);
+
     // Set CR3 (PDBR) register
     CPU::cr3(si->pmm.sys_pd);
 
@@ -618,6 +642,10 @@ void PC_Setup::setup_gdt()
     gdt[CPU::GDT_APP_DATA]  = GDT_Entry(0,  0xfffff, CPU::SEG_APP_DATA);
     gdt[CPU::GDT_TSS0]      = GDT_Entry(TSS0, 0xfff, CPU::SEG_TSS0);
 
+    // The other CPUs' TSSs follow TSS0 in the same page
+    for(unsigned int i = 1; i < Traits<PC>::CPUS; i++)
+        gdt[CPU::GDT_TSS1 + i - 1] = GDT_Entry(TSS0 + i * sizeof(TSS), sizeof(TSS) - 1, CPU::SEG_TSS0);
+
     db<Setup>(INF) << "GDT[NULL=" << CPU::GDT_NULL     << "]=" << gdt[CPU::GDT_NULL] << endl;
     db<Setup>(INF) << "GDT[SYCD=" << CPU::GDT_SYS_CODE << "]=" << gdt[CPU::GDT_SYS_CODE] << endl;
     db<Setup>(INF) << "GDT[SYDT=" << CPU::GDT_SYS_DATA << "]=" << gdt[CPU::GDT_SYS_DATA] << endl;
@@ -658,23 +686,26 @@ void PC_Setup::setup_sys_pt()
     // Clear the System Page Table
     memset(sys_pt, 0, sizeof(Page));
 
+    // The system is mapped alike in all address spaces, so its pages are global
+    // (i.e. their TLB entries survive address space switches)
+
     // IDT
-    sys_pt[MMU::page(IDT)] = si->pmm.idt | Flags::SYS;
+    sys_pt[MMU::page(IDT)] = si->pmm.idt | Flags::SYS | Flags::GLB;
 
     // GDT
-    sys_pt[MMU::page(GDT)] = si->pmm.gdt | Flags::SYS;
+    sys_pt[MMU::page(GDT)] = si->pmm.gdt | Flags::SYS | Flags::GLB;
 
     // TSS0
-    sys_pt[MMU::page(TSS0)] = si->pmm.tss0 | Flags::SYS;
+    sys_pt[MMU::page(TSS0)] = si->pmm.tss0 | Flags::SYS | Flags::GLB;
 
     // Set an entry to this page table, so the system can access it later
-    sys_pt[MMU::page(SYS_PT)] = si->pmm.sys_pt | Flags::SYS;
+    sys_pt[MMU::page(SYS_PT)] = si->pmm.sys_pt | Flags::SYS | Flags::GLB;
 
     // System Page Directory
-    sys_pt[MMU::page(SYS_PD)] = si->pmm.sys_pd | Flags::SYS;
+    sys_pt[MMU::page(SYS_PD)] = si->pmm.sys_pd | Flags::SYS | Flags::GLB;
 
     // System Info
-    sys_pt[MMU::page(SYS_INFO)] = si->pmm.sys_info | Flags::SYS;
+    sys_pt[MMU::page(SYS_INFO)] = si->pmm.sys_info | Flags::SYS | Flags::GLB;
 
     unsigned int i;
     PT_Entry aux;
@@ -683,19 +714,19 @@ void PC_Setup::setup_sys_pt()
     for(i = 0, aux = si->pmm.sys_code;
         i < MMU::pages(si->lm.sys_code_size);
         i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_CODE) + i] = aux | Flags::SYS;
+        sys_pt[MMU::page(SYS_CODE) + i] = aux | Flags::SYS | Flags::GLB;
 
     // SYSTEM data
     for(i = 0, aux = si->pmm.sys_data;
         i < MMU::pages(si->lm.sys_data_size);
         i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_DATA) + i] = aux | Flags::SYS;
+        sys_pt[MMU::page(SYS_DATA) + i] = aux | Flags::SYS | Flags::GLB;
 
     // SYSTEM stack (used only during init and for the ukernel model)
     for(i = 0, aux = si->pmm.sys_stack;
         i < MMU::pages(si->lm.sys_stack_size);
         i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_STACK) + i] = aux | Flags::SYS;
+        sys_pt[MMU::page(SYS_STACK) + i] = aux | Flags::SYS | Flags::GLB;
 
     db<Setup>(INF) << "SPT=" << *reinterpret_cast<Page_Table *>(sys_pt) << endl;
 }
@@ -720,22 +751,35 @@ void PC_Setup::setup_sys_pd()
     unsigned int mem_size = MMU::pages(si->bm.mem_top - si->bm.mem_base);
     int n_pts = (mem_size + MMU::PT_ENTRIES - 1) / MMU::PT_ENTRIES;
 
-    // Map all physical memory into the page tables pointed by phy_mem_pts
-    // These will be attached at both PHY_MEM and MEM_BASE thus flags
-    // must consider application access
-    PT_Entry * pts = reinterpret_cast<PT_Entry *>((void *)si->pmm.phy_mem_pts);
-    for(unsigned int i = MMU::pages(si->pmm.mem_base); i < mem_size; i++)
-        pts[i] = (i * sizeof(Page)) | Flags::APP;
-
-    // Attach all physical memory starting at PHY_MEM
-    for(int i = 0; i < n_pts; i++)
-        sys_pd[MMU::directory(PHY_MEM) + i] = (si->pmm.phy_mem_pts + i * sizeof(Page)) | Flags::SYS;
-
-    // Attach memory starting at MEM_BASE
-    for(unsigned int i = MMU::directory(MMU::align_directory(si->pmm.mem_base));
-        i < MMU::directory(MMU::align_directory(si->pmm.mem_top));
-        i++)
-        sys_pd[i] = (si->pmm.phy_mem_pts + i * sizeof(Page)) | Flags::APP;
+    PT_Entry * pts;
+    if(MMU::large_pages) {
+        // Attach all physical memory starting at PHY_MEM using 4 MB pages
+        for(int i = 0; i < n_pts; i++)
+            sys_pd[MMU::directory(PHY_MEM) + i] = (i * MMU::LARGE_PAGE_SIZE) | Flags::SYS | Flags::PS | Flags::GLB;
+
+        // Attach memory starting at MEM_BASE using 4 MB pages
+        for(unsigned int i = MMU::directory(MMU::align_directory(si->pmm.mem_base));
+            i < MMU::directory(MMU::align_directory(si->pmm.mem_top));
+            i++)
+            sys_pd[i] = (i * MMU::LARGE_PAGE_SIZE) | Flags::APP | Flags::PS;
+    } else {
+        // Map all physical memory into the page tables pointed by phy_mem_pts
+        // These will be attached at both PHY_MEM and MEM_BASE thus flags
+        // must consider application access
+        pts = reinterpret_cast<PT_Entry *>((void *)si->pmm.phy_mem_pts);
+        for(unsigned int i = MMU::pages(si->pmm.mem_base); i < mem_size; i++)
+            pts[i] = (i * sizeof(Page)) | Flags::APP;
+
+        // Attach all physical memory starting at PHY_MEM
+        for(int i = 0; i < n_pts; i++)
+            sys_pd[MMU::directory(PHY_MEM) + i] = (si->pmm.phy_mem_pts + i * sizeof(Page)) | Flags::SYS;
+
+        // Attach memory starting at MEM_BASE
+        for(unsigned int i = MMU::directory(MMU::align_directory(si->pmm.mem_base));
+            i < MMU::directory(MMU::align_directory(si->pmm.mem_top));
+            i++)
+            sys_pd[i] = (si->pmm.phy_mem_pts + i * sizeof(Page)) | Flags::APP;
+    }
 
     // Calculate the number of page tables needed to map the IO address space
     unsigned int io_size = MMU::pages(si->pmm.io_top - si->pmm.io_base);
@@ -743,11 +787,12 @@ void PC_Setup::setup_sys_pd()
 
     // Map IO address space into the page tables pointed by io_pts
     pts = reinterpret_cast<PT_Entry *>((void *)si->pmm.io_pts);
-    pts[0] = APIC_PHY | Flags::APIC;
+    pts[0] = APIC_PHY | Flags::APIC | Flags::GLB;
     for(unsigned int i = 1; i < 17; i++)
-        pts[i] = (VGA_PHY + i * sizeof(Page)) | Flags::VGA;
-    for(unsigned int i = 17; i < io_size; i++)
-        pts[i] = (si->pmm.io_base + i * sizeof(Page)) | Flags::PCI;
+        pts[i] = (VGA_PHY + i * sizeof(Page)) | Flags::VGA | Flags::GLB;
+    pts[17] = IO_APIC_PHY | Flags::APIC | Flags::GLB;
+    for(unsigned int i = 18; i < io_size; i++)
+        pts[i] = (si->pmm.io_base + (i - 18) * sizeof(Page)) | Flags::PCI | Flags::GLB; // see PCI::phy2log()
 
     // Attach PCI devices' memory at Memory_Map<PC>::PCI
     for(int i = 0; i < n_pts; i++)
@@ -760,32 +805,35 @@ void PC_Setup::setup_sys_pd()
 }
 
 //========================================================================
-void PC_Setup::setup_tss0()
+void PC_Setup::setup_tss()
 {
-    db<Setup>(TRC) << "setup_tss0(tss0=" << Log_Addr(TSS0) << ")" << endl;
-
-    // Get TSS0's logical address (after enabling paging)
-    TSS * tss0 = reinterpret_cast<TSS *>(TSS0);
-
-    // Clear TSS0
-    memset(tss0, 0, sizeof(Page));
-
-    // Configure only the segment selectors and the kernel stack on the bootstrap CPU
-    tss0->ss0 = CPU::SEL_SYS_DATA;
-    tss0->esp0 = SYS_STACK + Traits<System>::STACK_SIZE;
-    tss0->cs = (CPU::GDT_SYS_CODE << 3)  | CPU::PL_APP;
-    tss0->ss = (CPU::GDT_SYS_DATA << 3)  | CPU::PL_APP;
-    tss0->ds = tss0->ss;
-    tss0->es = tss0->ss;
-    tss0->fs = tss0->ss;
-    tss0->gs = tss0->ss;
-
-    // Load TR with TSS0
-    CPU::Reg16 tr = CPU::SEL_TSS0;
+    // Each CPU configures its own TSS (after enabling paging), all of them at once
+    int cpu_id = Machine::cpu_id();
+    TSS * tss = reinterpret_cast<TSS *>(TSS0 + cpu_id * sizeof(TSS));
+
+    db<Setup>(TRC) << "setup_tss(tss=" << tss << ")" << endl;
+
+    // Clear the TSS (the bootstrap CPU clears the whole page)
+    memset(tss, 0, cpu_id ? sizeof(TSS) : sizeof(Page));
+
+    // Configure only the segment selectors and the kernel stack (the same as in call_next())
+    tss->ss0 = CPU::SEL_SYS_DATA;
+    tss->esp0 = SYS_STACK + Traits<System>::STACK_SIZE * (cpu_id + 1);
+    tss->cs = (CPU::GDT_SYS_CODE << 3)  | CPU::PL_APP;
+    tss->ss = (CPU::GDT_SYS_DATA << 3)  | CPU::PL_APP;
+    tss->ds = tss->ss;
+    tss->es = tss->ss;
+    tss->fs = tss->ss;
+    tss->gs = tss->ss;
+    if(cpu_id)
+        tss->io_bmp = sizeof(TSS); // no I/O permission bitmap
+
+    // Load TR with the CPU's TSS
+    CPU::Reg16 tr = cpu_id ? ((CPU::GDT_TSS1 + cpu_id - 1) << 3) | CPU::PL_SYS : CPU::SEL_TSS0;
     CPU::tr(tr);
     tr = CPU::tr();
 
-    db<Setup>(INF) << "TR=" << tr << ",TSS0={ss0=" << tss0->ss0 << ",esp0=" << Log_Addr(tss0->esp0) << "}" << endl;
+    db<Setup>(INF) << "TR=" << tr << ",TSS={ss0=" << tss->ss0 << ",esp0=" << Log_Addr(tss->esp0) << "}" << endl;
 }
 
 //========================================================================
@@ -952,27 +1000,39 @@ void PC_Setup::calibrate_timers()
 {
     db<Setup>(TRC) << "PC_Setup::calibrate_timers()" << endl;
 
-    // Disable speaker so we can use channel 2 of i8253
-    i8255::port_b(i8255::port_b() & ~(i8255::SPEAKER | i8255::I8253_GATE2));
+    // The TSC is the system's clock source (see Clock::now()), so it is measured over two consecutive 25 ms
+    // windows, which must agree for its rate to be trusted
+    unsigned int ticks[2];
+    for(unsigned int i = 0; i < 2; i++) {
+        // Disable speaker so we can use channel 2 of i8253
+        i8255::port_b(i8255::port_b() & ~(i8255::SPEAKER | i8255::I8253_GATE2));
 
-    // Program i8253 channel 2 to count 50 ms
-    i8253::config(2, i8253::CLOCK/20, false, false);
+        // Program i8253 channel 2 to count 25 ms
+        i8253::config(2, i8253::CLOCK/40, false, false);
 
-    // Enable i8253 channel 2 counting
-    i8255::port_b(i8255::port_b() | i8255::I8253_GATE2);
+        // Enable i8253 channel 2 counting
+        i8255::port_b(i8255::port_b() | i8255::I8253_GATE2);
 
-    // Read CPU clock counter
-    TSC::Time_Stamp t0 = TSC::time_stamp();
+        // Read CPU clock counter
+        TSC::Time_Stamp t0 = TSC::serialized_time_stamp();
 
-    // Wait for i8253 counting to finish
-    while(!(i8255::port_b() & i8255::I8253_OUT2));
+        // Wait for i8253 counting to finish
+        while(!(i8255::port_b() & i8255::I8253_OUT2));
+
+        // Read CPU clock counter again
+        TSC::Time_Stamp t1 = TSC::serialized_time_stamp(); // ascending
 
-    // Read CPU clock counter again
-    TSC::Time_Stamp t1 = TSC::time_stamp(); // ascending
+        ticks[i] = t1 - t0;
+    }
 
-    si->tm.cpu_clock = (t1 - t0) * 20;
+    si->tm.cpu_clock = (ticks[0] + ticks[1]) * 20;
     db<Setup>(INF) << "PC_Setup::calibrate_timers:CPU clock=" << si->tm.cpu_clock / 1000000 << " MHz" << endl;
 
+    unsigned int diff = (ticks[0] > ticks[1]) ? ticks[0] - ticks[1] : ticks[1] - ticks[0];
+    if(diff > ticks[0] / 100)
+        db<Setup>(WRN) << "PC_Setup::calibrate_timers:TSC rate is unstable (" << ticks[0] << " vs " << ticks[1]
+                       << " ticks in 25 ms), time measurements will drift!" << endl;
+
     // Disable speaker so we can use channel 2 of i8253
     i8255::port_b(i8255::port_b() & ~(i8255::SPEAKER | i8255::I8253_GATE2));
 
@@ -1050,6 +1110,9 @@ void _start()
         // Initialize shared CPU counter
         si->bm.n_cpus = 1;
 
+        // Can't be stored in Boot_Stamp before SETUP is reloaded (see below)
+        TSC::Time_Stamp boot_stamp = TSC::time_stamp();
+
         // Broadcast INIT IPI to all APs excluding self
         APIC::ipi_init(si->bm.cpu_status);
         
@@ -1058,7 +1121,7 @@ void _start()
         // trampoline them into protected mode
         // PC_BOOT arranged for this code and stored it at 0x3000
         // ipi_start() waits for cpu_status to be incremented by the finc
-        // further down in this code
+        // further down in this code, for all APs at once
  	APIC::ipi_start(0x3000, si->bm.cpu_status);
 
  	if(si->bm.n_cpus > Traits<PC>::CPUS)
@@ -1094,21 +1157,16 @@ void _start()
         register char * dst = MMU::align_page(entry + size + Traits<PC>::CPUS * sizeof(MMU::Page));
         memcpy(dst, bi, si->bm.img_size);
 
+        Boot_Stamp = boot_stamp;
+
         // Passes a pointer to the just allocated stack pool to other CPUs
         Stacks = dst;
         Stacks_Ready = true;
         
     } else { // Additional CPUs (APs)
 
-        // Inform BSP that this AP has been initialized
-        CPU::finc(si->bm.cpu_status[APIC::id()]);
-
-        // Each AP increments the CPU counter
-        CPU::finc(si->bm.n_cpus);
-
-        // Wait for BSP's ACK
-        while(si->bm.cpu_status[APIC::id()] != 2);
-
+        // STARTUP IPIs are broadcast, so CPUs beyond the configuration wake up too
+        // (they have no cpu_status entry and must not be counted)
         if(APIC::id() >= int(Traits<PC>::CPUS)) {
             db<Setup>(WRN) << "More CPUs were detected than the current "
                            << "configuration supports (" << Traits<PC>::CPUS
@@ -1119,6 +1177,15 @@ void _start()
             CPU::halt();
         }
 
+        // Each AP increments the CPU counter (before reporting, so BSP's count is complete once all reported)
+        CPU::finc(si->bm.n_cpus);
+
+        // Inform BSP that this AP has been initialized
+        CPU::finc(si->bm.cpu_status[APIC::id()]);
+
+        // Wait for BSP's ACK
+        while(si->bm.cpu_status[APIC::id()] != 2);
+
         // Wait for the boot strap CPU to get us a stack
         while(!Stacks_Ready);
     }
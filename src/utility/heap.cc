@@ -1,6 +1,7 @@
 // EPOS Heap Utility Implementation
 
 #include <utility/heap.h>
+#include <uart.h>
 
 extern "C" { void _panic(); }
 
@@ -11,6 +12,13 @@ void Heap::out_of_memory()
 {
     db<Heaps>(ERR) << "Heap::alloc(this=" << this << "): out of memory!" << endl;
 
+    if(profiled) {
+        // Let tools/eposheap tell who is holding the memory
+        _profile.failures++;
+        UART uart;
+        dump(uart);
+    }
+
     _panic();
 }
 
@@ -38,6 +38,23 @@ int main()
     strcpy(sp, "string");
     cout << "new char[1024]\t\t=> {p=" << (void *)sp << ",v=" << sp << "}" << endl;
 
-    
+    cout << "and now growing a buffer!" << endl;
+    char * bp = reinterpret_cast<char *>(malloc(16));
+    strcpy(bp, "buffer");
+    for(unsigned int s = 32; s <= 4096; s *= 2) {
+        char * old = bp;
+        bp = reinterpret_cast<char *>(realloc(bp, s));
+        cout << "realloc(" << s << ")\t\t=> {p=" << (void *)bp << ",v=" << bp << ",usable=" << malloc_usable_size(bp)
+             << (bp == old ? ",in place}" : ",moved}") << endl;
+    }
+    free(bp);
+
+    cout << "and aligned blocks!" << endl;
+    for(unsigned int a = 16; a <= 4096; a *= 4) {
+        void * ap = memalign(a, 100);
+        cout << "memalign(" << a << ",100)\t=> {p=" << ap << ((reinterpret_cast<unsigned int>(ap) & (a - 1)) ? ",misaligned}" : ",aligned}") << endl;
+        free(ap);
+    }
+
     return 0;
 }
@@ -0,0 +1,86 @@
+// EPOS Region (Arena) Allocator Utility Implementation
+
+#include <utility/region.h>
+
+__BEGIN_UTIL
+
+// Methods
+Region::Region(unsigned int chunk_size): _chunk_size(chunk_size), _chunks(0), _top(0), _limit(0), _allocated(0)
+{
+    db<Heaps>(TRC) << "Region(chunk_size=" << chunk_size << ") => " << this << endl;
+}
+
+
+Region::~Region()
+{
+    db<Heaps>(TRC) << "~Region(this=" << this << ")" << endl;
+
+    while(_chunks) {
+        Chunk * next = _chunks->next;
+        release(_chunks);
+        _chunks = next;
+    }
+}
+
+
+void Region::reset()
+{
+    db<Heaps>(TRC) << "Region::reset(this=" << this << ",allocated=" << _allocated << ")" << endl;
+
+    if(!_chunks)
+        return;
+
+    // Chunks are stacked, the first one is at the bottom
+    while(_chunks->next) {
+        Chunk * next = _chunks->next;
+        release(_chunks);
+        _chunks = next;
+    }
+
+    _top = reinterpret_cast<char *>(_chunks) + sizeof(Chunk);
+    _limit = reinterpret_cast<char *>(_chunks) + _chunks->size;
+    _allocated = 0;
+}
+
+
+unsigned int Region::size() const
+{
+    unsigned int bytes = 0;
+    for(Chunk * c = _chunks; c; c = c->next)
+        bytes += c->size;
+
+    return bytes;
+}
+
+
+bool Region::grow(unsigned int bytes)
+{
+    unsigned int size = bytes + sizeof(Chunk);
+    if(size < _chunk_size)
+        size = _chunk_size;
+
+    Chunk * chunk = reinterpret_cast<Chunk *>(memalign(ALIGNMENT, size));
+    if(!chunk) {
+        db<Heaps>(WRN) << "Region::alloc(this=" << this << ",bytes=" << bytes << "): out of memory!" << endl;
+        return false;
+    }
+
+    chunk->next = _chunks;
+    chunk->size = size;
+    _chunks = chunk;
+
+    _top = reinterpret_cast<char *>(chunk) + sizeof(Chunk);
+    _limit = reinterpret_cast<char *>(chunk) + chunk->size;
+
+    db<Heaps>(INF) << "Region::grow(this=" << this << ",bytes=" << bytes << ") => " << chunk << endl;
+
+    return true;
+}
+
+
+void Region::release(Chunk * chunk)
+{
+    free(chunk);
+}
+
+__END_UTIL
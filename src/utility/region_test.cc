@@ -0,0 +1,59 @@
+// EPOS Region Allocator Utility Test Program
+
+#include <utility/ostream.h>
+#include <utility/region.h>
+#include <chronometer.h>
+
+using namespace EPOS;
+
+const unsigned int N = 10000;
+
+struct Node
+{
+    Node(int v, Node * n): value(v), next(n) {}
+
+    int value;
+    Node * next;
+};
+
+OStream cout;
+
+int main()
+{
+    cout << "Region Utility Test" << endl;
+
+    Region region;
+    Chronometer chrono;
+
+    for(unsigned int round = 0; round < 3; round++) {
+        chrono.reset();
+        chrono.start();
+        Node * list = 0;
+        for(unsigned int i = 0; i < N; i++)
+            list = new (region) Node(i, list);
+        unsigned int sum = 0;
+        for(Node * n = list; n; n = n->next)
+            sum += n->value;
+        region.reset();
+        chrono.stop();
+
+        cout << "Round " << round << ": " << N << " nodes (sum=" << sum << ") allocated and released in "
+             << chrono.read() << " us, region size=" << region.size() << " bytes" << endl;
+    }
+
+    cout << "Same thing with new and delete:" << endl;
+    chrono.reset();
+    chrono.start();
+    Node * list = 0;
+    for(unsigned int i = 0; i < N; i++)
+        list = new Node(i, list);
+    while(list) {
+        Node * n = list->next;
+        delete list;
+        list = n;
+    }
+    chrono.stop();
+    cout << "  " << N << " nodes allocated and released in " << chrono.read() << " us" << endl;
+
+    return 0;
+}
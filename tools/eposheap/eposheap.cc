@@ -0,0 +1,206 @@
+/*=======================================================================*/
+/* EPOSHEAP.CC                                                           */
+/*                                                                       */
+/* Desc: Tool to decode the heap profiles dumped by EPOS (Heap::dump())  */
+/*       from a capture of the serial line.                              */
+/*                                                                       */
+/* Parm: [capture file] (stdin if omitted)                               */
+/*                                                                       */
+/*=======================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CONSTANTS
+static const unsigned char MAGIC[] = { 'E', 'H', 'P' };
+static const unsigned char VERSION = 1;
+static const unsigned int MAX_CLASSES = 32;
+static const unsigned int MAX_SITES = 4096;
+static const unsigned int TOP_SITES = 20;
+
+// TYPES
+struct Site
+{
+    unsigned int address;
+    unsigned int blocks;
+    unsigned int bytes;
+};
+
+// PROTOTYPES
+bool get_byte(FILE * in, unsigned int * sum, unsigned char * byte);
+bool get_number(FILE * in, unsigned int * sum, unsigned int * n);
+bool decode(FILE * in, unsigned int dump);
+int by_bytes(const void * a, const void * b);
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char **argv)
+{
+    FILE * in = stdin;
+    if(argc > 1) {
+        in = fopen(argv[1], "rb");
+        if(!in) {
+            fprintf(stderr, "Error: can't open capture file \"%s\"!\n", argv[1]);
+            return 1;
+        }
+    }
+
+    // Dumps might be mixed with console output, so look for the magic
+    unsigned int dumps = 0;
+    unsigned int matched = 0;
+    int c;
+    while((c = fgetc(in)) != EOF) {
+        if(c == MAGIC[matched]) {
+            if(++matched == sizeof(MAGIC)) {
+                matched = 0;
+                if(fgetc(in) != VERSION) {
+                    fprintf(stderr, "Warning: skipping a dump in an unknown format!\n");
+                    continue;
+                }
+                if(!decode(in, dumps++))
+                    fprintf(stderr, "Warning: dump %u is truncated or corrupted!\n", dumps - 1);
+            }
+        } else
+            matched = (c == MAGIC[0]) ? 1 : 0;
+    }
+
+    if(!dumps)
+        fprintf(stderr, "No heap dumps found!\n");
+
+    if(in != stdin)
+        fclose(in);
+
+    return dumps ? 0 : 1;
+}
+
+//=============================================================================
+// DECODE
+//=============================================================================
+bool decode(FILE * in, unsigned int dump)
+{
+    unsigned int sum = 0;
+    unsigned int heap, capacity, used, peak, available, free_blocks, largest, frees, failures, classes;
+
+    if(!get_number(in, &sum, &heap) || !get_number(in, &sum, &capacity) || !get_number(in, &sum, &used)
+       || !get_number(in, &sum, &peak) || !get_number(in, &sum, &available) || !get_number(in, &sum, &free_blocks)
+       || !get_number(in, &sum, &largest) || !get_number(in, &sum, &frees) || !get_number(in, &sum, &failures)
+       || !get_number(in, &sum, &classes) || (classes > MAX_CLASSES))
+        return false;
+
+    unsigned int allocations[MAX_CLASSES];
+    unsigned int total = 0;
+    for(unsigned int i = 0; i < classes; i++) {
+        if(!get_number(in, &sum, &allocations[i]))
+            return false;
+        total += allocations[i];
+    }
+
+    static Site sites[MAX_SITES];
+    unsigned int n_sites = 0;
+    unsigned int blocks = 0;
+    unsigned int address, size;
+    while(true) {
+        if(!get_number(in, &sum, &address))
+            return false;
+        if(!address)
+            break;
+        if(!get_number(in, &sum, &size))
+            return false;
+        blocks++;
+
+        unsigned int i;
+        for(i = 0; (i < n_sites) && (sites[i].address != address); i++);
+        if(i == n_sites) {
+            if(n_sites == MAX_SITES)
+                continue;
+            sites[n_sites].address = address;
+            sites[n_sites].blocks = 0;
+            sites[n_sites].bytes = 0;
+            n_sites++;
+        }
+        sites[i].blocks++;
+        sites[i].bytes += size;
+    }
+
+    unsigned char lo, hi;
+    unsigned int dummy = 0;
+    if(!get_byte(in, &dummy, &lo) || !get_byte(in, &dummy, &hi))
+        return false;
+    if(static_cast<unsigned int>(lo | (hi << 8)) != (sum & 0xffff))
+        return false;
+
+    printf("Heap dump %u (heap at 0x%08x):\n", dump, heap);
+    printf("  Size:          %u bytes\n", capacity);
+    printf("  In use:        %u bytes (peak %u) in %u blocks\n", used, peak, blocks);
+    printf("  Free:          %u bytes in %u blocks, the largest with %u bytes\n", available, free_blocks, largest);
+    printf("  Fragmentation: %.1f%%\n", available ? 100.0 * (available - largest) / available : 0.0);
+    printf("  Allocations:   %u (%u frees, %u failures)\n", total, frees, failures);
+
+    printf("  Allocations by requested size:\n");
+    for(unsigned int i = 0; i < classes; i++)
+        if(allocations[i]) {
+            if(i == classes - 1)
+                printf("    > %9u: %u\n", 1U << (i + 3), allocations[i]);
+            else
+                printf("    <= %8u: %u\n", 1U << (i + 4), allocations[i]);
+        }
+
+    qsort(sites, n_sites, sizeof(Site), by_bytes);
+    printf("  Live blocks by allocation site (resolve with addr2line -f -e <image>):\n");
+    for(unsigned int i = 0; (i < n_sites) && (i < TOP_SITES); i++)
+        if(sites[i].address == 1)
+            printf("    %-10s %8u bytes in %u blocks\n", "unknown", sites[i].bytes, sites[i].blocks);
+        else
+            printf("    0x%08x %8u bytes in %u blocks\n", sites[i].address, sites[i].bytes, sites[i].blocks);
+    if(n_sites > TOP_SITES)
+        printf("    ... and %u other sites\n", n_sites - TOP_SITES);
+    printf("\n");
+
+    return true;
+}
+
+//=============================================================================
+// GET_BYTE
+//=============================================================================
+bool get_byte(FILE * in, unsigned int * sum, unsigned char * byte)
+{
+    int c = fgetc(in);
+    if(c == EOF)
+        return false;
+
+    *byte = c;
+    *sum += c;
+
+    return true;
+}
+
+//=============================================================================
+// GET_NUMBER (unsigned LEB128)
+//=============================================================================
+bool get_number(FILE * in, unsigned int * sum, unsigned int * n)
+{
+    unsigned char byte;
+    unsigned int shift = 0;
+
+    *n = 0;
+    do {
+        if(!get_byte(in, sum, &byte) || (shift > 28))
+            return false;
+        *n |= (byte & 0x7f) << shift;
+        shift += 7;
+    } while(byte & 0x80);
+
+    return true;
+}
+
+//=============================================================================
+// BY_BYTES
+//=============================================================================
+int by_bytes(const void * a, const void * b)
+{
+    const Site * sa = reinterpret_cast<const Site *>(a);
+    const Site * sb = reinterpret_cast<const Site *>(b);
+
+    return (sa->bytes < sb->bytes) - (sa->bytes > sb->bytes);
+}